@@ -1,6 +1,7 @@
 const fs = require("fs");
-const ncp = require("ncp");
-const { spawn } = require("child_process");
+const path = require("path");
+const crypto = require("crypto");
+const { spawn, execFileSync } = require("child_process");
 
 const pkg = require("./package.json");
 
@@ -9,8 +10,6 @@ const v8Version = process.versions.v8;
 const nodeVersion = process.versions.node;
 const architecture = process.arch;
 
-ncp.limit = 16;
-
 const dawnVersion = process.env.npm_config_dawnversion;
 if (!dawnVersion) throw `No Dawn version --dawnversion specified!`;
 
@@ -18,6 +17,19 @@ const bypassBuild = !!process.env.npm_config_bypass_build;
 
 const msvsVersion = process.env.npm_config_msvsversion || "";
 
+// parallel compile jobs, "max" uses all cores
+const buildJobs = process.env.npm_config_jobs || "max";
+
+// thin lto on clang, /GL and /LTCG on msvc
+const enableLTO = !!process.env.npm_config_lto;
+
+// builds an instrumented addon, runs the benchmarks on it and rebuilds with the collected profile
+const enablePGO = !!process.env.npm_config_pgo;
+const pgoSamples = process.env.npm_config_pgo_samples || 200;
+const llvmProfdata = process.env.npm_config_llvm_profdata || (
+  platform === "darwin" ? "xcrun llvm-profdata" : "llvm-profdata"
+);
+
 const generatePath = `${pkg.config.GEN_OUT_DIR}/${dawnVersion}/${platform}`;
 
 const unitPlatform = (
@@ -44,10 +56,17 @@ if (bypassBuild) {
   process.stderr.write(`Skipping build..\n`);
 }
 
+if (enablePGO && platform === "win32") {
+  process.stderr.write(`PGO builds require clang, which isn't used on Windows\n`);
+  process.stderr.write(`Exiting..\n`);
+  return;
+}
+
 // build
 // build/release
 let buildDir = `${generatePath}/build/`;
 let buildOutputDir = buildDir + "Release/";
+let pgoDir = path.resolve(buildDir + "pgo/");
 if (!fs.existsSync(buildDir)) fs.mkdirSync(buildDir);
 if (!fs.existsSync(buildOutputDir)) fs.mkdirSync(buildOutputDir);
 
@@ -58,6 +77,29 @@ Node: ${nodeVersion}
 V8: ${v8Version}
 `);
 
+function getFileHash(path) {
+  return crypto.createHash("sha1").update(fs.readFileSync(path)).digest("hex");
+};
+
+// copies a file or a folder, files with the same contents are skipped,
+// so they keep their timestamps and don't get recompiled
+// returns the number of copied files
+function copyChangedFiles(source, target) {
+  let stat = fs.statSync(source);
+  if (stat.isDirectory()) {
+    if (!fs.existsSync(target)) fs.mkdirSync(target, { recursive: true });
+    return fs.readdirSync(source).reduce((count, file) => {
+      return count + copyChangedFiles(`${source}/${file}`, `${target}/${file}`);
+    }, 0);
+  }
+  if (fs.existsSync(target)) {
+    let targetStat = fs.statSync(target);
+    if (targetStat.size === stat.size && getFileHash(source) === getFileHash(target)) return 0;
+  }
+  fs.copyFileSync(source, target);
+  return 1;
+};
+
 function copyFiles() {
   process.stdout.write(`\nCopying files..\n`);
   return new Promise(resolve => {
@@ -113,8 +155,6 @@ function copyFiles() {
       files.push([`${dawnOutputDir}/libshaderc.so`, targetDir]);
       files.push([`${dawnOutputDir}/libc++.so`, targetDir]);
     }
-    let counter = 0;
-    if (!files.length) return resolve(true);
     files.map(entry => {
       let source = entry[0];
       let target = entry[1];
@@ -123,22 +163,21 @@ function copyFiles() {
       let isFile = fileName.length > 0;
       if (isFile) target += "/" + fileName;
       // copy
-      ncp(source, target, error => {
-        process.stdout.write(`Copying ${source} -> ${target}\n`);
-        if (error) {
-          process.stderr.write(`Failed to copy ${source} -> ${target}\n`);
-          throw error;
-        }
-      });
-      if (counter++ >= files.length - 1) {
-        process.stdout.write("Done!\n");
-        resolve(true);
+      try {
+        let count = copyChangedFiles(source, target);
+        process.stdout.write(`Copying ${source} -> ${target} (${count} changed)\n`);
+      } catch (error) {
+        process.stderr.write(`Failed to copy ${source} -> ${target}\n`);
+        throw error;
       }
     });
+    process.stdout.write("Done!\n");
+    resolve(true);
   });
 };
 
-function buildFiles() {
+// 'pgo' is "none", "generate" or "use"
+function buildFiles(pgo = "none") {
   process.stdout.write(`\nCompiling bindings..\n`);
   return new Promise(resolve => {
     let msargs = "";
@@ -146,11 +185,27 @@ function buildFiles() {
     if (platform === "win32") {
       msargs += `--msvs_version ${msvsVersion}`;
     }
-    let cmd = `cd ${generatePath} && node-gyp configure && node-gyp build`;
+    // variables of binding.gyp
+    let gypArgs = `-Dlto=${enableLTO} -Dpgo=${pgo}`;
+    if (pgo === "use") gypArgs += ` -Dpgo_profile="${pgoDir}/addon.profdata"`;
+    if (enableLTO || pgo !== "none") process.stdout.write(`LTO: ${enableLTO} | PGO: ${pgo}\n`);
+    // only re-configure when the gyp file or its variables changed
+    let gypHash = crypto.createHash("sha1").update(getFileHash(`${generatePath}/binding.gyp`) + gypArgs).digest("hex");
+    let gypHashPath = `${buildDir}/binding.gyp.sha1`;
+    let configured = (
+      fs.existsSync(`${buildDir}/config.gypi`) &&
+      fs.existsSync(gypHashPath) &&
+      fs.readFileSync(gypHashPath, "utf-8") === gypHash
+    );
+    if (configured) process.stdout.write(`Skipping configure, binding.gyp is unchanged\n`);
+    let cmd = `cd ${generatePath} && ${configured ? "" : `node-gyp configure -- ${gypArgs} && `}node-gyp build --jobs ${buildJobs}`;
     let shell = spawn(cmd, { shell: true, stdio: "inherit" }, { stdio: "pipe" });
     shell.on("exit", error => {
       if (!error) {
-        actionsAfter();
+        fs.writeFileSync(gypHashPath, gypHash);
+        // the instrumented addon would write a profile when loaded, the
+        // layouts are handled after the final build anyway
+        if (pgo !== "generate") actionsAfter();
         process.stdout.write("Done!\n");
       }
       resolve(!error);
@@ -158,26 +213,84 @@ function buildFiles() {
   });
 };
 
+// the addon is loaded in a child process, so this process never holds a
+// module which a later build of the same run replaces
+function getAddonMemoryLayouts() {
+  const addonPath = path.resolve(`${buildOutputDir}/addon-${platform}.node`);
+  const script = `
+    const addon = require(${JSON.stringify(addonPath)});
+    process.stdout.write(JSON.stringify({
+      hash: addon.$memoryLayoutsHash,
+      layouts: addon.$getMemoryLayouts ? addon.$getMemoryLayouts() : null
+    }));
+  `;
+  return JSON.parse(execFileSync(process.execPath, ["-e", script], { encoding: "utf-8" }));
+};
+
 function inlineMemoryLayouts() {
-  const addon = require(`${buildOutputDir}/addon-${platform}.node`);
-  if (!addon.$getMemoryLayouts) return;
-  process.stdout.write(`Inlining memory layouts..\n`);
-  let memoryLayouts = addon.$getMemoryLayouts();
-  if (!fs.existsSync(`${generatePath}/memoryLayouts.json`)) {
-    process.stdout.write(`Pending bootstrapping, module should be re-generated!\n`);
+  const addon = getAddonMemoryLayouts();
+  const memoryLayoutsPath = `${generatePath}/memoryLayouts.json`;
+  if (addon.layouts === null) {
+    // the inlined layouts have to match the ones of this build, stale ones
+    // get deleted, so the next generation bootstraps them again
+    const encodersPath = `${generatePath}/memoryLayouts.js`;
+    let hash = fs.existsSync(encodersPath) ? require(encodersPath).hash : null;
+    if (hash !== addon.hash && fs.existsSync(memoryLayoutsPath)) {
+      process.stdout.write(`Memory layouts are stale, module should be re-generated and re-built to refresh them!\n`);
+      fs.unlinkSync(memoryLayoutsPath);
+    }
+    return;
   }
-  fs.writeFileSync(`${generatePath}/memoryLayouts.json`, JSON.stringify(memoryLayouts, null, 2));
+  process.stdout.write(`Dumping memory layouts..\n`);
+  fs.writeFileSync(memoryLayoutsPath, JSON.stringify(addon.layouts, null, 2));
+  process.stdout.write(`Memory layouts got dumped, module should be re-generated to inline them!\n`);
 };
 
 function actionsAfter() {
-  //inlineMemoryLayouts();
+  inlineMemoryLayouts();
+};
+
+function spawnCommand(cmd, env = process.env) {
+  return new Promise(resolve => {
+    let shell = spawn(cmd, { shell: true, stdio: "inherit", env });
+    shell.on("exit", error => resolve(!error));
+  });
+};
+
+// runs the headless benchmarks on the instrumented build and merges the written profiles
+async function collectProfile() {
+  process.stdout.write(`\nCollecting profile..\n`);
+  if (!fs.existsSync(pgoDir)) fs.mkdirSync(pgoDir, { recursive: true });
+  fs.readdirSync(pgoDir).map(file => fs.unlinkSync(`${pgoDir}/${file}`));
+  let env = Object.assign({}, process.env, {
+    LLVM_PROFILE_FILE: `${pgoDir}/addon-%p.profraw`
+  });
+  let benchmark = `node --experimental-modules tests/benchmark.mjs ${pgoSamples} "${pgoDir}/benchmark.json"`;
+  if (!(await spawnCommand(benchmark, env))) return false;
+  let profiles = fs.readdirSync(pgoDir).filter(file => file.endsWith(".profraw"));
+  if (profiles.length === 0) {
+    process.stderr.write(`No profile got written to ${pgoDir}\n`);
+    return false;
+  }
+  let merge = `${llvmProfdata} merge -output="${pgoDir}/addon.profdata" ` + profiles.map(file => `"${pgoDir}/${file}"`).join(" ");
+  if (!(await spawnCommand(merge))) return false;
+  process.stdout.write("Done!\n");
+  return true;
 };
 
 (async function run() {
   await copyFiles();
   let buildSuccess = false;
   if (!bypassBuild) {
-    buildSuccess = await buildFiles();
+    if (enablePGO) {
+      buildSuccess = (
+        await buildFiles("generate") &&
+        await collectProfile() &&
+        await buildFiles("use")
+      );
+    } else {
+      buildSuccess = await buildFiles();
+    }
   } else {
     buildSuccess = true;
   }
@@ -14,6 +14,11 @@ import {
   getExplortDeclarationName
 } from "../types.mjs";
 
+import {
+  getPackedMemberKind,
+  isPackableStructure
+} from "./memoryLayouts.mjs";
+
 let ast = null;
 
 const DEFAULT_OPTS_DECODE_STRUCT_MEMBER = {
@@ -29,6 +34,7 @@ const DEFAULT_OPTS_RESET_STRUCT = {
 
 const H_TEMPLATE = fs.readFileSync(`${pkg.config.TEMPLATE_DIR}/DescriptorDecoder-h.njk`, "utf-8");
 const CPP_TEMPLATE = fs.readFileSync(`${pkg.config.TEMPLATE_DIR}/DescriptorDecoder-cpp.njk`, "utf-8");
+const STRUCTURE_CPP_TEMPLATE = fs.readFileSync(`${pkg.config.TEMPLATE_DIR}/DescriptorDecoderStructure-cpp.njk`, "utf-8");
 
 nunjucks.configure({ autoescape: true });
 
@@ -107,6 +113,15 @@ ${padding}  Napi::String type = Napi::String::New(value.Env(), "Type");
 ${padding}  Napi::String message = Napi::String::New(value.Env(), "Expected '${unwrapType}' for '${structure.externalName}'.'${member.name}'");
 ${padding}  device->throwCallbackError(type, message);
 ${padding}  return ${insideDecoder ? "descriptor" : ""};
+${padding}}`;
+    }
+    // 64-bit numbers can be passed as BigInt too
+    else if (jsType.isNumber && rawType === "uint64_t") {
+      out += `\n${padding}if (!(${input.name}.Get("${member.name}").IsNumber()) && !(${input.name}.Get("${member.name}").IsBigInt())) {
+${padding}  Napi::String type = Napi::String::New(value.Env(), "Type");
+${padding}  Napi::String message = Napi::String::New(value.Env(), "Expected 'Number' or 'BigInt' for '${structure.externalName}'.'${member.name}'");
+${padding}  device->throwCallbackError(type, message);
+${padding}  return ${insideDecoder ? "descriptor" : ""};
 ${padding}}`;
     }
     // primitive type check
@@ -233,7 +248,7 @@ ${padding}${output.name}.${member.name} = data;`;
   // decode numeric typed members
   } else if (type.isNumber) {
     // validate input and type
-    {
+    if (rawType !== "uint64_t") {
       out += `\n${padding}if (!(${input.name}.Get("${member.name}").IsNumber())) {
 ${padding}  Napi::String type = Napi::String::New(value.Env(), "Type");
 ${padding}  Napi::String message = Napi::String::New(value.Env(), "Expected 'Number' for '${structure.externalName}'.'${member.name}'");
@@ -251,10 +266,14 @@ ${padding}}`;
       case "float": {
         out += `\n${padding}${output.name}.${member.name} = ${input.name}.Get("${member.name}").As<Napi::Number>().FloatValue();`;
       } break;
+      // the Number or BigInt type check is emitted above
       case "uint64_t": {
-        out += `\n${padding}{`;
-        out += `\n${padding}  ${output.name}.${member.name} = static_cast<uint64_t>(${input.name}.Get("${member.name}").As<Napi::Number>().Uint32Value());`;
-        out += `\n${padding}}`;
+        out += `\n${padding}if (!getUint64Value(${input.name}.Get("${member.name}"), ${output.name}.${member.name})) {
+${padding}  Napi::String type = Napi::String::New(value.Env(), "Range");
+${padding}  Napi::String message = Napi::String::New(value.Env(), "Expected a non-negative safe integer or a BigInt below 2^64 for '${structure.externalName}'.'${member.name}'");
+${padding}  device->throwCallbackError(type, message);
+${padding}  return ${insideDecoder ? "descriptor" : ""};
+${padding}}`;
       } break;
       case "const uint32_t*": {
         /*out += `\n      size_t size;`;
@@ -406,6 +425,54 @@ function getDestroyStructureMember(structure, member) {
   return out;
 };
 
+// resolves the pointers and objects of a packed structure, see 'PackedDescriptors.h'
+function getPatchStructureMember(structure, member) {
+  let {type} = member;
+  let {nativeType} = type;
+  let out = ``;
+  let padding = `    `;
+  let slot = `descriptor.${member.name}`;
+  switch (getPackedMemberKind(member)) {
+    case "object": {
+      let unwrapType = getExplortDeclarationName(nativeType);
+      out += `\n${padding}if (!PackedDescriptors::PatchHandle<${unwrapType}>(${slot})) return false;`;
+    } break;
+    case "objectArray": {
+      let unwrapType = getExplortDeclarationName(nativeType);
+      out += `\n${padding}if (!PackedDescriptors::PatchPointer(${slot}, descriptor.${type.length})) return false;`;
+      out += `\n${padding}if (${slot} == nullptr && descriptor.${type.length} > 0) return false;`;
+      out += `\n${padding}for (unsigned int ii = 0; ii < descriptor.${type.length}; ++ii) {`;
+      out += `\n${padding}  if (!PackedDescriptors::PatchHandle<${unwrapType}>(const_cast<${nativeType}*>(${slot})[ii])) return false;`;
+      out += `\n${padding}};`;
+    } break;
+    case "enumArray": {
+      out += `\n${padding}if (!PackedDescriptors::PatchPointer(${slot}, descriptor.${type.length})) return false;`;
+      out += `\n${padding}if (${slot} == nullptr && descriptor.${type.length} > 0) return false;`;
+    } break;
+    case "string": {
+      out += `\n${padding}if (!PackedDescriptors::PatchString(${slot})) return false;`;
+    } break;
+    case "structure": {
+      let exportType = getExplortDeclarationName(nativeType);
+      out += `\n${padding}if (!Patch${exportType}(device, ${slot})) return false;`;
+    } break;
+    case "structureReference": {
+      let exportType = getExplortDeclarationName(nativeType);
+      out += `\n${padding}if (!PackedDescriptors::PatchPointer(${slot}, 1)) return false;`;
+      out += `\n${padding}if (${slot} != nullptr && !Patch${exportType}(device, *const_cast<${nativeType}*>(${slot}))) return false;`;
+    } break;
+    case "structureArray": {
+      let exportType = getExplortDeclarationName(nativeType);
+      out += `\n${padding}if (!PackedDescriptors::PatchPointer(${slot}, descriptor.${type.length})) return false;`;
+      out += `\n${padding}if (${slot} == nullptr && descriptor.${type.length} > 0) return false;`;
+      out += `\n${padding}for (unsigned int ii = 0; ii < descriptor.${type.length}; ++ii) {`;
+      out += `\n${padding}  if (!Patch${exportType}(device, const_cast<${nativeType}*>(${slot})[ii])) return false;`;
+      out += `\n${padding}};`;
+    } break;
+  };
+  return out;
+};
+
 function getDecodeStructureParameters(structure, isHeaderFile) {
   let out = ``;
   out += `GPUDevice* device`;
@@ -460,7 +527,9 @@ export default function(astReference) {
     getDecodeStructureMember,
     getDescriptorInstanceReset,
     getEnumNameFromDawnEnumName,
-    getDecodeStructureParameters
+    getDecodeStructureParameters,
+    getPatchStructureMember,
+    isPackableStructure: structure => isPackableStructure(structure, ast)
   };
   // h
   {
@@ -474,5 +543,13 @@ export default function(astReference) {
     let output = nunjucks.renderString(template, vars);
     out.source = output;
   }
+  // cpp, per structure
+  {
+    let template = STRUCTURE_CPP_TEMPLATE;
+    out.structures = structures.map(struct => {
+      let output = nunjucks.renderString(template, Object.assign({ struct }, vars));
+      return { name: struct.externalName, source: output };
+    });
+  }
   return out;
 };
@@ -15,14 +15,18 @@ const DAWN_PATH = fs.readFileSync(pkg.config.DAWN_PATH, "utf-8");
 
 nunjucks.configure({ autoescape: true });
 
-export default function(astReference) {
+export default function(astReference, options = {}) {
   ast = astReference;
   let out = {};
   let vars = {
     DAWN_PATH,
+    DAWN_NATIVE_PROCS: !!options.dawnNativeProcs,
     SOURCE_INCLUDES: [
-      "src/*.cpp"
-    ].map(v => `"${v}"`)
+      "src/*.cpp",
+      "src/decoders/*.cpp"
+    ].map(v => `"${v}"`),
+    // one translation unit per structure, see 'descriptorDecoder.mjs'
+    DECODER_SOURCES: ast.structures.map(struct => `src/decoders/${struct.externalName}.cpp`)
   };
   // binding.gyp
   {
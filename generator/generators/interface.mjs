@@ -0,0 +1,70 @@
+import fs from "fs";
+import nunjucks from "nunjucks";
+
+import pkg from "../../package.json";
+
+import {
+  warn
+} from "../utils.mjs";
+
+import {
+  isPackableStructure
+} from "./memoryLayouts.mjs";
+
+let ast = null;
+
+const JS_TEMPLATE = fs.readFileSync(`${pkg.config.TEMPLATE_DIR}/interface-js.njk`, "utf-8");
+
+// these read the descriptor object themselves, ignore it or are hot encoder calls
+const UNPACKED_METHODS = [
+  "GPUCommandEncoder.finish",
+  "GPUDevice.createBufferMapped",
+  "GPUDevice.createShaderModule",
+  "GPUInstance.createSurface",
+  "GPUQueue.createFence",
+  "GPURenderPassEncoder.setBlendColor"
+];
+
+nunjucks.configure({ autoescape: true });
+
+// methods which take a single, packable descriptor
+function getPackedMethods() {
+  let out = [];
+  ast.objects.map(object => {
+    object.children.map(method => {
+      if (method.children.length !== 1) return;
+      let {type} = method.children[0];
+      if (!type.isStructure) return;
+      if (UNPACKED_METHODS.indexOf(`${object.externalName}.${method.name}`) > -1) return;
+      let structure = ast.structures.find(s => s.name === type.nativeType);
+      if (!structure) {
+        warn(`Cannot resolve descriptor of '${object.externalName}'.'${method.name}'`);
+        return;
+      }
+      if (!isPackableStructure(structure, ast)) return;
+      out.push({
+        name: method.name,
+        className: object.externalName,
+        descriptorName: structure.externalName
+      });
+    });
+  });
+  return out;
+};
+
+export default function(astReference, { minified }) {
+  ast = astReference;
+  let out = {};
+  let vars = {
+    minified,
+    methods: getPackedMethods(),
+    classes: ast.objects.map(object => object.externalName)
+  };
+  // js
+  {
+    let template = JS_TEMPLATE;
+    let output = nunjucks.renderString(template, vars);
+    out.source = output;
+  }
+  return out;
+};
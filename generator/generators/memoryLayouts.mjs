@@ -4,26 +4,277 @@ import nunjucks from "nunjucks";
 import pkg from "../../package.json";
 
 import {
-  warn
+  warn,
+  getEnumNameFromDawnEnumName
 } from "../utils.mjs";
 
+import {
+  getExplortDeclarationName
+} from "../types.mjs";
+
 let ast = null;
+let pointerSize = 8;
 
 const H_TEMPLATE = fs.readFileSync(`${pkg.config.TEMPLATE_DIR}/memoryLayouts-h.njk`, "utf-8");
+const JS_TEMPLATE = fs.readFileSync(`${pkg.config.TEMPLATE_DIR}/memoryLayouts-js.njk`, "utf-8");
 
 nunjucks.configure({ autoescape: true });
 
-export default function(astReference) {
+const PACKED_NUMBER_TYPES = {
+  "uint32_t": "Uint32",
+  "int32_t": "Int32",
+  "float": "Float32",
+  "uint64_t": "Uint64"
+};
+
+// FNV-1a, has to match 'MemoryLayoutsHash' in memoryLayouts.h
+function hashLayouts(structures, layouts) {
+  let hash = 0x811C9DC5;
+  let add = value => {
+    for (let ii = 0; ii < 4; ++ii) {
+      hash ^= (value >>> (ii * 8)) & 0xFF;
+      hash = Math.imul(hash, 0x01000193) >>> 0;
+    };
+  };
+  structures.map(struct => {
+    let layout = layouts[struct.name];
+    struct.children.map(member => {
+      add(layout[member.name].byteOffset);
+      add(layout[member.name].byteLength);
+    });
+    add(layout.byteLength);
+  });
+  return hash >>> 0;
+};
+
+// how a struct member is laid out in a packed descriptor
+// returns null if the member can't be packed (raw data, typed arrays)
+export function getPackedMemberKind(member) {
+  let {type} = member;
+  if (member.isInternalProperty) return "internal";
+  if (type.isString) return type.isDynamicLength ? "string" : null;
+  if (type.isObject) return type.isArray ? "objectArray" : "object";
+  if (type.isStructure) {
+    if (!type.isArray) return type.isReference ? "structureReference" : "structure";
+    return type.isArrayOfPointers ? null : "structureArray";
+  }
+  if (type.isEnum) return type.isArray ? "enumArray" : "enum";
+  if (type.isArray) return null;
+  if (type.isBitmask) return "bitmask";
+  if (type.isBoolean) return "boolean";
+  if (type.isNumber && PACKED_NUMBER_TYPES.hasOwnProperty(type.rawType)) return "number";
+  return null;
+};
+
+// a structure is packable if all its members, and the ones of its member structures are
+export function isPackableStructure(structure, astReference, visited = []) {
+  if (visited.indexOf(structure) > -1) return true;
+  visited.push(structure);
+  return structure.children.every(member => {
+    let kind = getPackedMemberKind(member);
+    if (kind === null) return false;
+    if (member.type.isStructure) {
+      let memberStructure = astReference.structures.find(s => s.name === member.type.nativeType);
+      if (!memberStructure) return false;
+      return isPackableStructure(memberStructure, astReference, visited);
+    }
+    return true;
+  });
+};
+
+function getPackedDefaultValue(member) {
+  let {type} = member;
+  let value = member.hasOwnProperty("defaultValueNative") ? member.defaultValueNative : type.initialValue;
+  if (value === undefined || value === null) return 0;
+  if (typeof value === "number") return value;
+  if (value === "true") return 1;
+  if (value === "false") return 0;
+  let number = Number(String(value).replace(/f$/, ""));
+  if (Number.isNaN(number)) {
+    warn(`Cannot use default value '${value}' of '${member.name}' in packed descriptors`);
+    return 0;
+  }
+  return number;
+};
+
+// returns the js code which writes a single member of a structure at 'at'
+function getEncodeStructureMember(structure, member, layouts) {
+  let {type} = member;
+  let kind = getPackedMemberKind(member);
+  let layout = layouts[structure.name][member.name];
+  let offset = layout.byteOffset;
+  let slot = `at + ${offset}`;
+  let length = null;
+  if (type.length && layouts[structure.name][type.length]) {
+    length = layouts[structure.name][type.length];
+  }
+  let padding = `  `;
+  let out = ``;
+  let input = `value.${member.name}`;
+  let missing = type.isRequired ? `return false;` : null;
+  switch (kind) {
+    case "internal": return ``;
+    case "number":
+    case "bitmask":
+    case "boolean": {
+      let defaultValue = getPackedDefaultValue(member);
+      let write = kind === "number" ? PACKED_NUMBER_TYPES[type.rawType] : (kind === "boolean" ? "Uint8" : "Uint32");
+      out += `\n${padding}{`;
+      out += `\n${padding}  let v = ${input};`;
+      if (missing) out += `\n${padding}  if (v === undefined) ${missing}`;
+      else out += `\n${padding}  if (v === undefined) v = ${defaultValue};`;
+      if (kind === "boolean") out += `\n${padding}  view.setUint8(${slot}, v ? 1 : 0);`;
+      else if (write === "Uint64") out += `\n${padding}  if (!writeUint64(${slot}, v)) return false;`;
+      else {
+        out += `\n${padding}  if (typeof v !== "number") return false;`;
+        out += `\n${padding}  view.set${write}(${slot}, v, true);`;
+      }
+      out += `\n${padding}}`;
+    } break;
+    case "enum": {
+      let map = getExplortDeclarationName(type.nativeType);
+      out += `\n${padding}{`;
+      out += `\n${padding}  let v = ${input};`;
+      if (missing) {
+        out += `\n${padding}  if (v === undefined) ${missing}`;
+        out += `\n${padding}  v = ${map}[v];`;
+        out += `\n${padding}  if (v === undefined) return false;`;
+      } else {
+        out += `\n${padding}  v = v === undefined ? ${getPackedDefaultValue(member)} : ${map}[v];`;
+        out += `\n${padding}  if (v === undefined) return false;`;
+      }
+      out += `\n${padding}  view.setUint32(${slot}, v, true);`;
+      out += `\n${padding}}`;
+    } break;
+    case "string": {
+      out += `\n${padding}if (${input} !== undefined) {`;
+      out += `\n${padding}  if (typeof ${input} !== "string") return false;`;
+      out += `\n${padding}  writePointer(${slot}, writeString(${input}));`;
+      out += `\n${padding}}`;
+      if (missing) out += ` else ${missing}`;
+    } break;
+    case "object": {
+      out += `\n${padding}if (${input} !== undefined && ${input} !== null) {`;
+      out += `\n${padding}  writePointer(${slot}, writeHandle(${input}));`;
+      out += `\n${padding}}`;
+      if (missing) out += ` else ${missing}`;
+    } break;
+    case "objectArray":
+    case "enumArray":
+    case "structureArray": {
+      let memberStructure = type.isStructure ? ast.structures.find(s => s.name === type.nativeType) : null;
+      let stride = (
+        kind === "enumArray" ? 4 :
+        kind === "structureArray" ? layouts[memberStructure.name].byteLength :
+        pointerSize
+      );
+      out += `\n${padding}if (Array.isArray(${input})) {`;
+      out += `\n${padding}  let array = ${input};`;
+      out += `\n${padding}  let data = reserve(array.length * ${stride});`;
+      out += `\n${padding}  for (let ii = 0; ii < array.length; ++ii) {`;
+      if (kind === "objectArray") {
+        out += `\n${padding}    writePointer(data + ii * ${stride}, writeHandle(array[ii]));`;
+      } else if (kind === "enumArray") {
+        let map = getExplortDeclarationName(type.nativeType);
+        out += `\n${padding}    let v = ${map}[array[ii]];`;
+        out += `\n${padding}    if (v === undefined) return false;`;
+        out += `\n${padding}    view.setUint32(data + ii * ${stride}, v, true);`;
+      } else {
+        out += `\n${padding}    if (!encode${memberStructure.externalName}(array[ii], data + ii * ${stride})) return false;`;
+      }
+      out += `\n${padding}  };`;
+      out += `\n${padding}  writePointer(${slot}, data);`;
+      if (length) out += `\n${padding}  view.setUint32(at + ${length.byteOffset}, array.length, true);`;
+      out += `\n${padding}}`;
+      if (missing) out += ` else ${missing}`;
+    } break;
+    case "structure": {
+      let memberStructure = ast.structures.find(s => s.name === type.nativeType);
+      // omitted optional structures still get their defaults
+      out += `\n${padding}if (!encode${memberStructure.externalName}(${input} !== undefined ? ${input} : EMPTY, ${slot})) return false;`;
+      if (missing) {
+        out = `\n${padding}if (${input} === undefined) ${missing}` + out;
+      }
+    } break;
+    case "structureReference": {
+      let memberStructure = ast.structures.find(s => s.name === type.nativeType);
+      out += `\n${padding}if (${input} !== undefined && ${input} !== null) {`;
+      out += `\n${padding}  let data = reserve(${layouts[memberStructure.name].byteLength});`;
+      out += `\n${padding}  if (!encode${memberStructure.externalName}(${input}, data)) return false;`;
+      out += `\n${padding}  writePointer(${slot}, data);`;
+      out += `\n${padding}}`;
+      if (missing) out += ` else ${missing}`;
+    } break;
+    default: {
+      warn(`Cannot pack member '${structure.externalName}'.'${member.name}'`);
+    } break;
+  };
+  return out;
+};
+
+// the dumped layouts have to cover every member of every structure
+export function isMemoryLayoutsComplete(astReference, layouts) {
+  return astReference.structures.every(struct => {
+    let layout = layouts[struct.name];
+    if (!layout || typeof layout.byteLength !== "number") return false;
+    return struct.children.every(member => !!layout[member.name]);
+  });
+};
+
+export default function(astReference, layouts = null) {
   ast = astReference;
   let out = {};
-  let vars = {
-    structures: ast.structures
-  };
+  let structures = ast.structures;
+  let packableStructures = structures.filter(struct => isPackableStructure(struct, ast));
   // h
   {
+    let vars = {
+      structures
+    };
     let template = H_TEMPLATE;
     let output = nunjucks.renderString(template, vars);
     out.header = output;
   }
+  // js, only available once the layouts got dumped by the native module
+  if (layouts) {
+    if (!isMemoryLayoutsComplete(ast, layouts)) {
+      warn(`Memory layouts are outdated`);
+      return out;
+    }
+    // object handles are pointers too
+    pointerSize = layouts["WGPUBindGroupDescriptor"].layout.byteLength;
+    let usedEnums = [];
+    packableStructures.map(struct => {
+      struct.children.map(member => {
+        if (member.type.isEnum && usedEnums.indexOf(member.type.nativeType) === -1) {
+          usedEnums.push(member.type.nativeType);
+        }
+      });
+    });
+    let enums = ast.enums.filter(e => usedEnums.indexOf(e.name) > -1).map(e => {
+      return {
+        externalName: e.externalName,
+        children: e.children.map(member => {
+          return { name: getEnumNameFromDawnEnumName(member.name), value: member.value };
+        })
+      };
+    });
+    let encoders = packableStructures.map(struct => {
+      return {
+        name: struct.name,
+        externalName: struct.externalName,
+        byteLength: layouts[struct.name].byteLength,
+        body: struct.children.map(member => getEncodeStructureMember(struct, member, layouts)).join("")
+      };
+    });
+    let vars = {
+      hash: hashLayouts(structures, layouts),
+      enums,
+      encoders
+    };
+    let template = JS_TEMPLATE;
+    let output = nunjucks.renderString(template, vars);
+    out.source = output;
+  }
   return out;
 };
@@ -0,0 +1,104 @@
+import fs from "fs";
+import nunjucks from "nunjucks";
+
+import pkg from "../../package.json";
+
+import {
+  warn,
+  firstLetterToUpperCase,
+  firstLetterToLowerCase
+} from "../utils.mjs";
+
+import {
+  getExplortDeclarationName
+} from "../types.mjs";
+
+let ast = null;
+
+// call dawn_native's procs directly, instead of dawn_proc's 'wgpu*' exports
+let dawnNativeProcs = false;
+
+const H_TEMPLATE = fs.readFileSync(`${pkg.config.TEMPLATE_DIR}/PassEncoderProcs-h.njk`, "utf-8");
+
+// the encoders which share the 'PassEncoderBase' implementation
+const PASS_ENCODERS = [
+  "WGPURenderPassEncoder",
+  "WGPUComputePassEncoder",
+  "WGPURenderBundleEncoder",
+  "WGPURayTracingPassEncoder"
+];
+
+nunjucks.configure({ autoescape: true });
+
+// methods which only take numbers get decoded directly from the call arguments
+function isScalarMethod(method) {
+  if (method.children.length === 0) return false;
+  return method.children.every(arg => {
+    return arg.type.isNumber && !arg.type.isReference;
+  });
+};
+
+function getScalarArgumentDecoder(arg, index) {
+  let {type} = arg;
+  if (type.isRequired) return `Arguments::Get<${type.rawType}>(info, ${index})`;
+  return `Arguments::Get<${type.rawType}>(info, ${index}, ${type.initialValue})`;
+};
+
+function getEncoderProcs(object) {
+  let out = {
+    name: object.name,
+    externalName: object.externalName,
+    pipeline: null,
+    methods: []
+  };
+  let objectName = object.name.substr(4);
+  object.children.map(method => {
+    let procName = firstLetterToUpperCase(method.name);
+    let dawnName = `wgpu${objectName}${procName}`;
+    if (dawnNativeProcs) {
+      dawnName = `DawnProcs::native.${firstLetterToLowerCase(objectName)}${procName}`;
+    }
+    let entry = {
+      name: method.name,
+      procName,
+      dawnName,
+      isScalar: isScalarMethod(method),
+      returnType: method.type.rawType || "void",
+      parameters: method.children.map(arg => `${arg.type.rawType} ${arg.name}`),
+      arguments: method.children.map(arg => arg.name),
+      decoders: method.children.map(getScalarArgumentDecoder)
+    };
+    if (method.name === "setPipeline") {
+      out.pipeline = getExplortDeclarationName(method.children[0].type.nativeType);
+    }
+    out.methods.push(entry);
+  });
+  if (!out.pipeline) warn(`Encoder '${object.name}' has no 'setPipeline' method`);
+  return out;
+};
+
+export default function(astReference, options = {}) {
+  ast = astReference;
+  dawnNativeProcs = !!options.dawnNativeProcs;
+  let out = {};
+  let encoders = PASS_ENCODERS.map(name => {
+    let object = ast.objects.find(object => object.name === name);
+    if (!object) warn(`Cannot resolve pass encoder '${name}'`);
+    return object;
+  }).filter(object => !!object).map(getEncoderProcs);
+  let pipelines = encoders.map(encoder => encoder.pipeline).filter((pipeline, index, self) => {
+    return !!pipeline && self.indexOf(pipeline) === index;
+  });
+  let vars = {
+    encoders,
+    pipelines,
+    DAWN_NATIVE_PROCS: dawnNativeProcs
+  };
+  // h
+  {
+    let template = H_TEMPLATE;
+    let output = nunjucks.renderString(template, vars);
+    out.header = output;
+  }
+  return out;
+};
@@ -13,8 +13,12 @@ import {
 import generateAST from "./generators/ast.mjs";
 import generateGyp from "./generators/gyp.mjs";
 import generateIndex from "./generators/index.mjs";
-import generateMemoryLayouts from "./generators/memoryLayouts.mjs";
+import generateMemoryLayouts, {
+  isMemoryLayoutsComplete
+} from "./generators/memoryLayouts.mjs";
 import generateDescriptorDecoder from "./generators/descriptorDecoder.mjs";
+import generatePassEncoders from "./generators/passEncoders.mjs";
+import generateInterface from "./generators/interface.mjs";
 
 const DAWN_PATH = normalizeDawnPath(fs.readFileSync(pkg.config.DAWN_PATH, "utf-8"));
 
@@ -34,11 +38,28 @@ const generatePath = `${generateVersionPath}/${getPlatform()}`;
 const generateSrcPath = `${generatePath}/src`;
 const bypassBuild = !!process.env.npm_config_bypass_build;
 
-// enables js interface minifcation
-const enableMinification = false;
+// binds the hot encoder paths directly to dawn_native's procs
+const dawnNativeProcs = !!process.env.npm_config_dawn_native_procs;
 
-// indicating if it's necessary to include memorylayouts in the build
-const includeMemoryLayouts = false /*!fs.existsSync(`${generatePath}/memoryLayouts.json`)*/;
+// enables js interface minifcation, generated shims and frozen prototypes
+const enableMinification = !process.env.npm_config_disable_minification;
+
+// the layouts get dumped after building, see 'inlineMemoryLayouts' in build.js
+// build.js deletes them if they don't match the hash of the build anymore
+const memoryLayoutsPath = `${generatePath}/memoryLayouts.json`;
+
+// returns the dumped memory layouts, or null if they have to be (re-)bootstrapped
+// layouts which miss structures of the specification are deleted
+function readMemoryLayouts(ast) {
+  if (!fs.existsSync(memoryLayoutsPath)) return null;
+  let layouts = JSON.parse(fs.readFileSync(memoryLayoutsPath, "utf-8"));
+  if (!isMemoryLayoutsComplete(ast, layouts)) {
+    console.log(`Memory layouts are outdated, deleting them to re-bootstrap!`);
+    fs.unlinkSync(memoryLayoutsPath);
+    return null;
+  }
+  return layouts;
+};
 
 function writeGeneratedFile(path, text, includeNotice = true) {
   if (typeof text !== "string") throw new TypeError(`Expected 'string' type for parameter 'text'`);
@@ -53,7 +74,7 @@ function writeGeneratedFile(path, text, includeNotice = true) {
   }
 };
 
-async function generateBindings(version, enableMinification, includeMemoryLayouts) {
+async function generateBindings(version, enableMinification) {
   // copy dawn.json specification from dawn folder into into specification folder
   fs.copyFileSync(
     DAWN_PATH + "/dawn.json",
@@ -67,7 +88,7 @@ async function generateBindings(version, enableMinification, includeMemoryLayout
     console.log(`Fake platform: '${fakePlatform}' - Real platform: '${process.platform}'`);
   }
   if (!enableMinification) console.log(`Code minification is disabled!`);
-  if (includeMemoryLayouts) console.log(`Memory layouts are not inlined yet.`);
+  if (dawnNativeProcs) console.log(`Binding encoders directly to dawn_native procs!`);
   // reserve dst write paths
   {
     // generated/
@@ -81,6 +102,10 @@ async function generateBindings(version, enableMinification, includeMemoryLayout
   }
   console.log(`Generating bindings for ${version}...`);
   let ast = generateAST(JSON.parse(JSONspecification));
+  // indicating if it's necessary to include memorylayouts in the build
+  let memoryLayouts = readMemoryLayouts(ast);
+  let includeMemoryLayouts = memoryLayouts === null;
+  if (includeMemoryLayouts) console.log(`Memory layouts aren't dumped yet, descriptors can't be packed until re-generating after the next build!`);
   // generate AST
   {
     let out = JSON.stringify(ast, null, 2);
@@ -89,7 +114,7 @@ async function generateBindings(version, enableMinification, includeMemoryLayout
   }
   // generate gyp
   {
-    let out = generateGyp(ast);
+    let out = generateGyp(ast, { dawnNativeProcs });
     // .gyp
     writeGeneratedFile(`${generatePath}/binding.gyp`, out.gyp, false);
   }
@@ -103,9 +128,15 @@ async function generateBindings(version, enableMinification, includeMemoryLayout
   }
   // generate memorylayouts
   {
-    let out = generateMemoryLayouts(ast);
+    let out = generateMemoryLayouts(ast, memoryLayouts);
     // .h
     writeGeneratedFile(`${generatePath}/src/memoryLayouts.h`, out.header);
+    // .js
+    if (out.source) {
+      writeGeneratedFile(`${generatePath}/memoryLayouts.js`, out.source);
+    } else if (fs.existsSync(`${generatePath}/memoryLayouts.js`)) {
+      fs.unlinkSync(`${generatePath}/memoryLayouts.js`);
+    }
   }
   // generate descriptor decoder
   {
@@ -114,6 +145,29 @@ async function generateBindings(version, enableMinification, includeMemoryLayout
     writeGeneratedFile(`${generatePath}/src/DescriptorDecoder.h`, out.header);
     // .cpp
     writeGeneratedFile(`${generatePath}/src/DescriptorDecoder.cpp`, out.source);
+    // .cpp, per structure
+    let decodersPath = `${generateSrcPath}/decoders`;
+    if (!fs.existsSync(decodersPath)) fs.mkdirSync(decodersPath);
+    let decoderFiles = out.structures.map(struct => `${struct.name}.cpp`);
+    out.structures.map(struct => {
+      writeGeneratedFile(`${decodersPath}/${struct.name}.cpp`, struct.source);
+    });
+    // remove decoders of structures which are gone
+    fs.readdirSync(decodersPath).map(file => {
+      if (decoderFiles.indexOf(file) === -1) fs.unlinkSync(`${decodersPath}/${file}`);
+    });
+  }
+  // generate pass encoder procs
+  {
+    let out = generatePassEncoders(ast, { dawnNativeProcs });
+    // .h
+    writeGeneratedFile(`${generatePath}/src/PassEncoderProcs.h`, out.header);
+  }
+  // generate js interface
+  {
+    let out = generateInterface(ast, { minified: enableMinification });
+    // .js
+    writeGeneratedFile(`${generatePath}/interface.js`, out.source);
   }
   console.log(`Successfully generated bindings!`);
 };
@@ -123,7 +177,6 @@ if (bypassBuild) {
 } else {
   generateBindings(
     dawnVersion,
-    enableMinification,
-    includeMemoryLayouts
+    enableMinification
   );
 }
@@ -73,6 +73,10 @@ export function firstLetterToUpperCase(str) {
   return str[0].toUpperCase() + str.substr(1);
 };
 
+export function firstLetterToLowerCase(str) {
+  return str[0].toLowerCase() + str.substr(1);
+};
+
 export function isQuotedString(str) {
   return !!((String(str)).match(/"[^"]*"/g));
 };
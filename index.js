@@ -25,26 +25,25 @@ module.exports.GPU.$setPlatform(process.platform);
     };
   });
   const {GPUAdapter} = module.exports;
-  GPUAdapter.prototype.requestDevice = function() {
-    let args = arguments;
-    return new Promise((resolve, reject) => {
-      this._requestDevice(...args).then(device => {
-        device._onErrorCallback = function(type, msg) {
-          setImmediate(() => {
-            switch (type) {
-              case "Error": throw new Error(msg); break;
-              case "Type": throw new TypeError(msg); break;
-              case "Range": throw new RangeError(msg); break;
-              case "Reference": throw new ReferenceError(msg); break;
-              case "Internal": throw new InternalError(msg); break;
-              case "Syntax": throw new SyntaxError(msg); break;
-              default: throw new Error(msg); break;
-            };
-          });
-        };
-        devices.push(device);
-        resolve(device);
-      });
+  // shared by all devices
+  function onErrorCallback(type, msg) {
+    setImmediate(() => {
+      switch (type) {
+        case "Error": throw new Error(msg); break;
+        case "Type": throw new TypeError(msg); break;
+        case "Range": throw new RangeError(msg); break;
+        case "Reference": throw new ReferenceError(msg); break;
+        case "Internal": throw new InternalError(msg); break;
+        case "Syntax": throw new SyntaxError(msg); break;
+        default: throw new Error(msg); break;
+      };
+    });
+  };
+  GPUAdapter.prototype.requestDevice = function(descriptor) {
+    return this._requestDevice(descriptor).then(device => {
+      device._onErrorCallback = onErrorCallback;
+      devices.push(device);
+      return device;
     });
   };
 }
@@ -80,6 +79,31 @@ module.exports.GPU.$setPlatform(process.platform);
     });
   };
 }
+{
+  const {GPUQueue} = module.exports;
+  // readbacks get resolved during device ticks,
+  // keep ticking as long as there are readbacks in flight
+  let tickingQueues = new WeakSet();
+  function tickReadbacks(queue) {
+    if (queue._tickReadbacks() > 0) setImmediate(tickReadbacks, queue);
+    else tickingQueues.delete(queue);
+  };
+  function scheduleReadbacks(queue) {
+    if (tickingQueues.has(queue)) return;
+    tickingQueues.add(queue);
+    setImmediate(tickReadbacks, queue);
+  };
+  GPUQueue.prototype.readBuffer = function(buffer, offset, size) {
+    let promise = this._readBuffer(buffer, offset, size);
+    scheduleReadbacks(this);
+    return promise;
+  };
+  GPUQueue.prototype.readTexture = function(source, size) {
+    let promise = this._readTexture(source, size);
+    scheduleReadbacks(this);
+    return promise;
+  };
+}
 {
   const {GPUDevice} = module.exports;
   GPUDevice.prototype.createBufferMappedAsync = function(descriptor) {
@@ -90,3 +114,182 @@ module.exports.GPU.$setPlatform(process.platform);
     });
   };
 }
+{
+  const {WebGPUWindow} = module.exports;
+  // record types of the window's event queue, keep in sync with EventQueue.h
+  WebGPUWindow.EventType = Object.freeze({
+    RESIZE: 1,
+    FOCUS: 2,
+    CLOSE: 3,
+    KEY_DOWN: 4,
+    KEY_UP: 5,
+    MOUSE_MOVE: 6,
+    MOUSE_WHEEL: 7,
+    MOUSE_DOWN: 8,
+    MOUSE_UP: 9,
+    DROP: 10
+  });
+}
+{
+  const {GPUSwapChain} = module.exports;
+  const {performance} = require("perf_hooks");
+  // calls the callback once the swapchain is ready for the next frame,
+  // which is when less than 'maxFramesInFlight' frames are still processed
+  // by the GPU and the frame interval of 'targetFrameRate' elapsed
+  GPUSwapChain.prototype.requestFrame = function(callback) {
+    // blocked by the GPU, the frame fence completes during device ticks,
+    // which are spaced out instead of spinning
+    let waitFrame = () => {
+      if (this._waitFrame()) setTimeout(waitFrame, 1);
+      else tickFrame();
+    };
+    let tickFrame = () => {
+      let wait = this._tickFrame();
+      if (wait === 0) callback(performance.now());
+      else if (wait < 0) waitFrame();
+      // ahead of the target rate
+      else setTimeout(tickFrame, wait);
+    };
+    setImmediate(tickFrame);
+  };
+}
+
+// the generated js interface, the shims are generic wrappers when minification is disabled
+const interfacePath = `${generatedPath}/interface.js`;
+const generatedInterface = fs.existsSync(interfacePath) ? require(interfacePath) : null;
+
+// descriptors get packed into the memory layouts of their native structures by
+// the generated encoders, as long as these match the layouts of the native module
+let installedShims = 0;
+{
+  const {GPU} = module.exports;
+  const memoryLayoutsPath = `${generatedPath}/memoryLayouts.js`;
+  let memoryLayouts = fs.existsSync(memoryLayoutsPath) ? require(memoryLayoutsPath) : null;
+  if (memoryLayouts !== null && memoryLayouts.hash !== module.exports.$memoryLayoutsHash) {
+    process.emitWarning(`Memory layouts are outdated, re-generate the bindings to pack descriptors`);
+    memoryLayouts = null;
+  }
+  GPU.packedDescriptors = memoryLayouts !== null;
+  // captures have to record the descriptors themselves
+  const state = { packing: true };
+  if (memoryLayouts !== null) {
+    memoryLayouts.setScratchCallback((buffer, handles) => {
+      GPU.$setMemoryLayoutScratch(buffer, handles);
+    });
+    const {startCapture, stopCapture} = GPU;
+    GPU.startCapture = function() {
+      state.packing = false;
+      return startCapture.call(this);
+    };
+    GPU.stopCapture = function() {
+      state.packing = true;
+      return stopCapture.call(this);
+    };
+  }
+  // only methods with a packer get a shim, without layouts all methods stay native
+  if (generatedInterface !== null) {
+    installedShims = generatedInterface(module.exports, memoryLayouts !== null ? memoryLayouts.packers : {}, state);
+  }
+}
+
+// measures per-pass durations with timestamp queries, the results are
+// read back asynchronously and accumulated into rolling histograms
+// the query sets are emulated, their timestamps are taken on the CPU while
+// encoding, so the durations are encoding times and not GPU execution times
+{
+  const {GPUBufferUsage} = module.exports;
+  class PassEncodeTimer {
+    constructor(device, {maxPasses = 32, historySize = 256} = {}) {
+      this.device = device;
+      this.queue = device.getQueue();
+      this.maxPasses = maxPasses;
+      this.historySize = historySize;
+      this.querySet = device.createQuerySet({ type: "timestamp", count: maxPasses * 2 });
+      this.emulated = this.querySet.emulated;
+      // names of the passes measured since the last resolve
+      this.passes = [];
+      this.resolved = [];
+      this.freeBuffers = [];
+      this.histograms = new Map();
+    }
+    // returns the index of the pass, which has to be passed to 'end'
+    begin(encoder, name) {
+      let index = this.passes.length;
+      if (index >= this.maxPasses) return -1;
+      this.passes.push(name);
+      encoder.writeTimestamp(this.querySet, index * 2 + 0);
+      return index;
+    }
+    end(encoder, index) {
+      if (index < 0) return;
+      encoder.writeTimestamp(this.querySet, index * 2 + 1);
+    }
+    // records the resolve of all passes measured so far into the encoder
+    resolve(encoder) {
+      if (this.passes.length === 0) return;
+      let buffer = this.freeBuffers.pop() || this.device.createBuffer({
+        size: this.maxPasses * 2 * 8,
+        usage: GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST
+      });
+      encoder.resolveQuerySet(this.querySet, 0, this.passes.length * 2, buffer, 0);
+      this.resolved.push({ buffer, passes: this.passes });
+      this.passes = [];
+    }
+    // has to be called after the command buffers with the resolves got submitted
+    collect() {
+      for (let ii = 0; ii < this.resolved.length; ++ii) {
+        let {buffer, passes} = this.resolved[ii];
+        this.queue.readBuffer(buffer, 0, passes.length * 2 * 8).then(data => {
+          let timestamps = new BigUint64Array(data);
+          for (let jj = 0; jj < passes.length; ++jj) {
+            let duration = timestamps[jj * 2 + 1] - timestamps[jj * 2 + 0];
+            // nanoseconds to milliseconds
+            this.record(passes[jj], Number(duration) * 1e-6);
+          };
+          this.freeBuffers.push(buffer);
+        }, () => {
+          // the durations of a failed readback are dropped, the buffer is reused
+          this.freeBuffers.push(buffer);
+        });
+      };
+      this.resolved = [];
+    }
+    record(name, duration) {
+      let histogram = this.histograms.get(name);
+      if (!histogram) {
+        histogram = { samples: new Float64Array(this.historySize), count: 0 };
+        this.histograms.set(name, histogram);
+      }
+      histogram.samples[histogram.count++ % this.historySize] = duration;
+    }
+    // statistics over the last 'historySize' durations of the given pass, in milliseconds
+    getStats(name) {
+      let histogram = this.histograms.get(name);
+      if (!histogram || histogram.count === 0) return null;
+      let length = Math.min(histogram.count, this.historySize);
+      let sorted = histogram.samples.slice(0, length).sort();
+      let sum = 0;
+      for (let ii = 0; ii < length; ++ii) sum += sorted[ii];
+      let percentile = p => sorted[Math.min(length - 1, Math.floor(length * p))];
+      return {
+        count: length,
+        mean: sum / length,
+        min: sorted[0],
+        max: sorted[length - 1],
+        p50: percentile(0.50),
+        p90: percentile(0.90),
+        p99: percentile(0.99)
+      };
+    }
+    destroy() {
+      this.querySet.destroy();
+      this.freeBuffers.map(buffer => buffer.destroy());
+      this.freeBuffers = [];
+    }
+  };
+  module.exports.PassEncodeTimer = PassEncodeTimer;
+}
+
+// no more changes to the prototypes from here on
+module.exports.GPU.minifiedInterface = generatedInterface !== null && generatedInterface.minified && installedShims > 0;
+if (generatedInterface !== null) generatedInterface.freeze(module.exports);
@@ -0,0 +1,66 @@
+#ifndef __ARGUMENTS_H__
+#define __ARGUMENTS_H__
+
+#define NAPI_EXPERIMENTAL
+#include <napi.h>
+
+#include <string>
+#include <cstdint>
+
+// type-specialized decoding of call arguments, directly through the C API
+// instead of wrapping each argument into a 'Napi::Number' first
+// required arguments throw a TypeError and decode to 0 if they aren't a number,
+// optional ones fall back
+namespace Arguments {
+
+  template<typename T> T Get(const Napi::CallbackInfo& info, size_t index);
+  template<typename T> T Get(const Napi::CallbackInfo& info, size_t index, T fallback);
+
+  // throws a TypeError if the argument couldn't be decoded as a number
+  inline bool Expect(const Napi::CallbackInfo& info, size_t index, napi_status status) {
+    if (status == napi_ok) return true;
+    std::string message = "Expected 'Number' for argument " + std::to_string(index + 1);
+    Napi::TypeError::New(info.Env(), message).ThrowAsJavaScriptException();
+    return false;
+  };
+
+  template<> inline uint32_t Get<uint32_t>(const Napi::CallbackInfo& info, size_t index) {
+    uint32_t out = 0;
+    if (!Expect(info, index, napi_get_value_uint32(info.Env(), info[index], &out))) return 0;
+    return out;
+  };
+  template<> inline uint32_t Get<uint32_t>(const Napi::CallbackInfo& info, size_t index, uint32_t fallback) {
+    uint32_t out = 0;
+    if (napi_get_value_uint32(info.Env(), info[index], &out) != napi_ok) return fallback;
+    return out;
+  };
+
+  template<> inline int32_t Get<int32_t>(const Napi::CallbackInfo& info, size_t index) {
+    int32_t out = 0;
+    if (!Expect(info, index, napi_get_value_int32(info.Env(), info[index], &out))) return 0;
+    return out;
+  };
+  template<> inline int32_t Get<int32_t>(const Napi::CallbackInfo& info, size_t index, int32_t fallback) {
+    int32_t out = 0;
+    if (napi_get_value_int32(info.Env(), info[index], &out) != napi_ok) return fallback;
+    return out;
+  };
+
+  template<> inline float Get<float>(const Napi::CallbackInfo& info, size_t index) {
+    double out = 0.0;
+    if (!Expect(info, index, napi_get_value_double(info.Env(), info[index], &out))) return 0.0f;
+    return static_cast<float>(out);
+  };
+  template<> inline float Get<float>(const Napi::CallbackInfo& info, size_t index, float fallback) {
+    double out = 0.0;
+    if (napi_get_value_double(info.Env(), info[index], &out) != napi_ok) return fallback;
+    return static_cast<float>(out);
+  };
+
+  template<typename T> inline T* Unwrap(const Napi::CallbackInfo& info, size_t index) {
+    return Napi::ObjectWrap<T>::Unwrap(info[index].As<Napi::Object>());
+  };
+
+}
+
+#endif
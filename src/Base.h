@@ -12,3 +12,7 @@
 #include <algorithm>
 
 #include "Utils.h"
+#include "Profiler.h"
+#include "Tracer.h"
+#include "FrameStats.h"
+#include "Capture.h"
@@ -0,0 +1,645 @@
+#include "Capture.h"
+
+#include "GPUDevice.h"
+#include "GPUBuffer.h"
+#include "GPUSwapChain.h"
+#include "GPUCanvasContext.h"
+#include "GPUShaderModule.h"
+#include "WebGPUWindow.h"
+
+#include "DescriptorDecoder.h"
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+namespace Capture {
+
+  static const char kMagic[8] = { 'W', 'G', 'P', 'U', 'C', 'A', 'P', 'T' };
+
+  bool enabled = false;
+
+  // the finished records
+  static std::vector<uint8_t> stream;
+  // the record which is currently serialized, objects which are
+  // seen the first time while serializing get emitted before it
+  static std::vector<uint8_t> scratch;
+
+  // method ids by the name of their profiler entry, -1 for methods which aren't captured
+  static std::unordered_map<const std::string*, int32_t> methodIds;
+  static uint32_t methodCount = 0;
+
+  // object ids by their native wrapper, all captured objects are kept alive,
+  // so the address of a wrapper can't get reused while capturing
+  static std::unordered_map<void*, uint32_t> objectIds;
+  static std::vector<Napi::ObjectReference> objects;
+
+  static uint32_t callCount = 0;
+
+  template<typename T> static void Write(std::vector<uint8_t>& out, T value) {
+    size_t offset = out.size();
+    out.resize(offset + sizeof(T));
+    memcpy(out.data() + offset, &value, sizeof(T));
+  };
+
+  static void WriteBytes(std::vector<uint8_t>& out, const void* data, uint64_t size) {
+    Write<uint64_t>(out, size);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    if (size > 0) out.insert(out.end(), bytes, bytes + size);
+  };
+
+  static void WriteString(std::vector<uint8_t>& out, const std::string& str) {
+    WriteBytes(out, str.data(), str.size());
+  };
+
+  static void* Unwrap(Napi::Env env, const Napi::Value& value) {
+    void* native = nullptr;
+    if (napi_unwrap(env, value, &native) != napi_ok) return nullptr;
+    return native;
+  };
+
+  static uint32_t RegisterObject(const Napi::Object& object, void* native) {
+    uint32_t id = static_cast<uint32_t>(objects.size());
+    objects.push_back(Napi::Persistent(object));
+    objectIds[native] = id;
+    return id;
+  };
+
+  static uint32_t GetObjectId(const Napi::Object& object, void* native) {
+    auto it = objectIds.find(native);
+    if (it != objectIds.end()) return it->second;
+    // the object was created before capturing started
+    uint32_t id = RegisterObject(object, native);
+    Napi::Object constructor = object.Get("constructor").As<Napi::Object>();
+    Write<uint8_t>(stream, kRecordExternal);
+    Write<uint32_t>(stream, id);
+    WriteString(stream, constructor.Get("name").As<Napi::String>().Utf8Value());
+    return id;
+  };
+
+  static void WriteValue(std::vector<uint8_t>& out, Napi::Env env, const Napi::Value& value);
+
+  static void WriteObject(std::vector<uint8_t>& out, Napi::Env env, const Napi::Object& object) {
+    if (object.IsArrayBuffer()) {
+      Napi::ArrayBuffer buffer = object.As<Napi::ArrayBuffer>();
+      Write<uint8_t>(out, kValueArrayBuffer);
+      WriteBytes(out, buffer.Data(), buffer.ByteLength());
+    }
+    else if (object.IsTypedArray()) {
+      Napi::TypedArray array = object.As<Napi::TypedArray>();
+      const uint8_t* data = reinterpret_cast<const uint8_t*>(array.ArrayBuffer().Data()) + array.ByteOffset();
+      Write<uint8_t>(out, kValueTypedArray);
+      Write<uint8_t>(out, static_cast<uint8_t>(array.TypedArrayType()));
+      WriteBytes(out, data, array.ByteLength());
+    }
+    else if (object.IsArray()) {
+      Napi::Array array = object.As<Napi::Array>();
+      uint32_t length = array.Length();
+      Write<uint8_t>(out, kValueArray);
+      Write<uint32_t>(out, length);
+      for (uint32_t ii = 0; ii < length; ++ii) WriteValue(out, env, array.Get(ii));
+    }
+    else if (void* native = Unwrap(env, object)) {
+      Write<uint8_t>(out, kValueWrapped);
+      Write<uint32_t>(out, GetObjectId(object, native));
+    }
+    else {
+      Napi::Array keys = object.GetPropertyNames();
+      uint32_t length = keys.Length();
+      Write<uint8_t>(out, kValueObject);
+      Write<uint32_t>(out, length);
+      for (uint32_t ii = 0; ii < length; ++ii) {
+        Napi::Value key = keys.Get(ii);
+        WriteString(out, key.ToString().Utf8Value());
+        WriteValue(out, env, object.Get(key));
+      };
+    }
+  };
+
+  static void WriteValue(std::vector<uint8_t>& out, Napi::Env env, const Napi::Value& value) {
+    switch (value.Type()) {
+      case napi_null: {
+        Write<uint8_t>(out, kValueNull);
+      } break;
+      case napi_boolean: {
+        Write<uint8_t>(out, value.As<Napi::Boolean>().Value() ? kValueTrue : kValueFalse);
+      } break;
+      case napi_number: {
+        Write<uint8_t>(out, kValueNumber);
+        Write<double>(out, value.As<Napi::Number>().DoubleValue());
+      } break;
+      case napi_bigint: {
+        bool lossless = false;
+        Write<uint8_t>(out, kValueBigInt);
+        Write<uint64_t>(out, value.As<Napi::BigInt>().Uint64Value(&lossless));
+      } break;
+      case napi_string: {
+        Write<uint8_t>(out, kValueString);
+        WriteString(out, value.As<Napi::String>().Utf8Value());
+      } break;
+      // callbacks become no-ops on replay
+      case napi_function: {
+        Write<uint8_t>(out, kValueFunction);
+      } break;
+      case napi_object: {
+        WriteObject(out, env, value.As<Napi::Object>());
+      } break;
+      default: {
+        Write<uint8_t>(out, kValueUndefined);
+      } break;
+    };
+  };
+
+  // adapters and canvas contexts only exist on the capturing side
+  static bool IsCapturedMethod(const std::string& name) {
+    if (name.compare(0, 11, "GPUAdapter.") == 0) return false;
+    if (name.compare(0, 17, "GPUCanvasContext.") == 0) return false;
+    return name.compare(0, 3, "GPU") == 0;
+  };
+
+  static int32_t GetMethodId(const std::string& name) {
+    auto it = methodIds.find(&name);
+    if (it != methodIds.end()) return it->second;
+    int32_t id = IsCapturedMethod(name) ? static_cast<int32_t>(methodCount++) : -1;
+    methodIds[&name] = id;
+    if (id >= 0) {
+      Write<uint8_t>(stream, kRecordMethod);
+      Write<uint32_t>(stream, static_cast<uint32_t>(id));
+      WriteString(stream, name);
+    }
+    return id;
+  };
+
+  // shaders are captured as SPIR-V, so the replayer doesn't have to compile GLSL
+  static Napi::Value GetSPIRVShaderModuleDescriptor(Napi::Env env, const Napi::Value& value) {
+    if (!value.IsObject()) return value;
+    Napi::Object descriptor = value.As<Napi::Object>();
+    Napi::Value code = descriptor.Get("code");
+    if (!code.IsString()) return value;
+    std::vector<uint32_t> spirv;
+    std::string error;
+    // invalid shaders are captured as they are and fail the same way on replay
+    if (!GPUShaderModule::CompileGLSL(code.As<Napi::String>().Utf8Value(), spirv, error)) return value;
+    Napi::Object out = Napi::Object::New(env);
+    Napi::Array keys = descriptor.GetPropertyNames();
+    for (uint32_t ii = 0; ii < keys.Length(); ++ii) {
+      Napi::Value key = keys.Get(ii);
+      out.Set(key, descriptor.Get(key));
+    };
+    Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, spirv.size() * sizeof(uint32_t));
+    memcpy(buffer.Data(), spirv.data(), buffer.ByteLength());
+    out.Set("code", Napi::Uint32Array::New(env, spirv.size(), buffer, 0));
+    return out;
+  };
+
+  ScopedCall::ScopedCall(const Napi::CallbackInfo& info, const std::string& name) {
+    Napi::Env env = info.Env();
+    // the swapchain gets replaced by an offscreen texture on replay
+    if (name == "GPUCanvasContext.configureSwapChain") {
+      this->mode = kSwapChain;
+      return;
+    }
+    int32_t methodId = GetMethodId(name);
+    if (methodId < 0) return;
+    this->mode = kCall;
+    this->index = callCount++;
+    scratch.clear();
+    // writes into mapped memory aren't visible as calls
+    if (name == "GPUBuffer.unmap") {
+      Napi::Object object = info.This().As<Napi::Object>();
+      GPUBuffer* buffer = Napi::ObjectWrap<GPUBuffer>::Unwrap(object);
+      if (buffer->mappedData != nullptr) {
+        Write<uint8_t>(scratch, kRecordContents);
+        Write<uint32_t>(scratch, GetObjectId(object, Unwrap(env, object)));
+        WriteBytes(scratch, buffer->mappedData, buffer->mappedLength);
+      }
+    }
+    Write<uint8_t>(scratch, kRecordCall);
+    Write<uint32_t>(scratch, static_cast<uint32_t>(methodId));
+    WriteValue(scratch, env, info.This());
+    Write<uint32_t>(scratch, static_cast<uint32_t>(info.Length()));
+    for (size_t ii = 0; ii < info.Length(); ++ii) {
+      if (ii == 0 && name == "GPUDevice.createShaderModule") {
+        WriteValue(scratch, env, GetSPIRVShaderModuleDescriptor(env, info[ii]));
+      } else {
+        WriteValue(scratch, env, info[ii]);
+      }
+    };
+    stream.insert(stream.end(), scratch.begin(), scratch.end());
+  };
+
+  // objects can be returned directly or inside an array, e.g. by 'createBufferMapped'
+  static void CollectResultObjects(Napi::Env env, const Napi::Value& result, std::vector<Napi::Object>& out) {
+    if (!result.IsObject()) return;
+    if (Unwrap(env, result) != nullptr) {
+      out.push_back(result.As<Napi::Object>());
+    }
+    else if (result.IsArray()) {
+      Napi::Array array = result.As<Napi::Array>();
+      for (uint32_t ii = 0; ii < array.Length(); ++ii) {
+        Napi::Value item = array.Get(ii);
+        if (item.IsObject() && Unwrap(env, item) != nullptr) out.push_back(item.As<Napi::Object>());
+      };
+    }
+  };
+
+  void ScopedCall::SetResult(const Napi::Value& result) {
+    // capturing could have been stopped by a callback
+    if (this->mode == kSkip || !enabled || result.IsEmpty()) return;
+    Napi::Env env = result.Env();
+    if (this->mode == kSwapChain) {
+      if (!result.IsObject()) return;
+      Napi::Object object = result.As<Napi::Object>();
+      GPUSwapChain* swapChain = Napi::ObjectWrap<GPUSwapChain>::Unwrap(object);
+      GPUCanvasContext* context = Napi::ObjectWrap<GPUCanvasContext>::Unwrap(swapChain->context.Value());
+      WebGPUWindow* window = Napi::ObjectWrap<WebGPUWindow>::Unwrap(context->window.Value());
+      Write<uint8_t>(stream, kRecordSwapChain);
+      Write<uint32_t>(stream, RegisterObject(object, Unwrap(env, object)));
+      Write<uint32_t>(stream, static_cast<uint32_t>(window->width));
+      Write<uint32_t>(stream, static_cast<uint32_t>(window->height));
+      WriteString(stream, DescriptorDecoder::GPUTextureFormat(static_cast<uint32_t>(swapChain->format)));
+      Write<uint32_t>(stream, static_cast<uint32_t>(swapChain->usage));
+      return;
+    }
+    std::vector<Napi::Object> results;
+    CollectResultObjects(env, result, results);
+    if (results.empty()) return;
+    Write<uint8_t>(stream, kRecordResult);
+    Write<uint32_t>(stream, this->index);
+    Write<uint32_t>(stream, static_cast<uint32_t>(results.size()));
+    for (Napi::Object& object : results) {
+      void* native = Unwrap(env, object);
+      auto it = objectIds.find(native);
+      Write<uint32_t>(stream, it != objectIds.end() ? it->second : RegisterObject(object, native));
+    };
+  };
+
+  static void Reset() {
+    methodIds.clear();
+    methodCount = 0;
+    objectIds.clear();
+    objects.clear();
+    callCount = 0;
+  };
+
+  Napi::Value StartCapture(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (enabled) return env.Undefined();
+    Reset();
+    stream.clear();
+    stream.insert(stream.end(), kMagic, kMagic + sizeof(kMagic));
+    Write<uint32_t>(stream, kVersion);
+    enabled = true;
+    return env.Undefined();
+  };
+
+  Napi::Value StopCapture(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (!enabled) return env.Undefined();
+    enabled = false;
+    Napi::ArrayBuffer out = Napi::ArrayBuffer::New(env, stream.size());
+    memcpy(out.Data(), stream.data(), stream.size());
+    // releases the captured objects
+    Reset();
+    std::vector<uint8_t>().swap(stream);
+    std::vector<uint8_t>().swap(scratch);
+    return out;
+  };
+
+  struct Reader {
+    const uint8_t* data = nullptr;
+    uint64_t size = 0;
+    uint64_t offset = 0;
+    bool failed = false;
+
+    template<typename T> T Read() {
+      T value{};
+      if (failed || size - offset < sizeof(T)) {
+        failed = true;
+        return value;
+      }
+      memcpy(&value, data + offset, sizeof(T));
+      offset += sizeof(T);
+      return value;
+    };
+
+    const uint8_t* ReadBytes(uint64_t& length) {
+      length = Read<uint64_t>();
+      if (failed || size - offset < length) {
+        failed = true;
+        length = 0;
+        return nullptr;
+      }
+      const uint8_t* bytes = data + offset;
+      offset += length;
+      return bytes;
+    };
+
+    std::string ReadString() {
+      uint64_t length = 0;
+      const uint8_t* bytes = ReadBytes(length);
+      if (failed) return std::string();
+      return std::string(reinterpret_cast<const char*>(bytes), length);
+    };
+  };
+
+  struct ReplayMethod {
+    std::string className;
+    std::string name;
+  };
+
+  struct Replayer {
+    Reader reader;
+    Napi::Object device;
+    Napi::FunctionReference noop;
+    std::vector<ReplayMethod> methods;
+    std::vector<Napi::ObjectReference> objects;
+    // offscreen textures which replace the captured swapchains
+    std::unordered_map<uint32_t, std::string> swapChainFormats;
+    // id of the last object read by 'ReadValue'
+    uint32_t lastObjectId = 0;
+  };
+
+  static size_t GetTypedArrayElementSize(napi_typedarray_type type) {
+    switch (type) {
+      case napi_int8_array:
+      case napi_uint8_array:
+      case napi_uint8_clamped_array:
+        return 1;
+      case napi_int16_array:
+      case napi_uint16_array:
+        return 2;
+      case napi_int32_array:
+      case napi_uint32_array:
+      case napi_float32_array:
+        return 4;
+      case napi_float64_array:
+      case napi_bigint64_array:
+      case napi_biguint64_array:
+        return 8;
+    };
+    return 0;
+  };
+
+  static void SetObject(Replayer& replayer, uint32_t id, const Napi::Object& object) {
+    if (id >= replayer.objects.size()) replayer.objects.resize(id + 1);
+    replayer.objects[id] = Napi::Persistent(object);
+  };
+
+  static Napi::Value ReadValue(Napi::Env env, Replayer& replayer) {
+    Reader& reader = replayer.reader;
+    switch (reader.Read<uint8_t>()) {
+      case kValueUndefined: return env.Undefined();
+      case kValueNull: return env.Null();
+      case kValueFalse: return Napi::Boolean::New(env, false);
+      case kValueTrue: return Napi::Boolean::New(env, true);
+      case kValueNumber: return Napi::Number::New(env, reader.Read<double>());
+      case kValueBigInt: return Napi::BigInt::New(env, reader.Read<uint64_t>());
+      case kValueString: return Napi::String::New(env, reader.ReadString());
+      case kValueFunction: return replayer.noop.Value();
+      case kValueArrayBuffer: {
+        uint64_t length = 0;
+        const uint8_t* bytes = reader.ReadBytes(length);
+        Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, length);
+        if (length > 0) memcpy(buffer.Data(), bytes, length);
+        return buffer;
+      }
+      case kValueTypedArray: {
+        napi_typedarray_type type = static_cast<napi_typedarray_type>(reader.Read<uint8_t>());
+        uint64_t length = 0;
+        const uint8_t* bytes = reader.ReadBytes(length);
+        size_t elementSize = GetTypedArrayElementSize(type);
+        if (reader.failed || elementSize == 0 || length % elementSize != 0) break;
+        Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, length);
+        if (length > 0) memcpy(buffer.Data(), bytes, length);
+        napi_value array = nullptr;
+        napi_create_typedarray(env, type, length / elementSize, buffer, 0, &array);
+        return Napi::Value(env, array);
+      }
+      case kValueArray: {
+        uint32_t length = reader.Read<uint32_t>();
+        Napi::Array array = Napi::Array::New(env);
+        for (uint32_t ii = 0; ii < length && !reader.failed; ++ii) array.Set(ii, ReadValue(env, replayer));
+        return array;
+      }
+      case kValueObject: {
+        uint32_t length = reader.Read<uint32_t>();
+        Napi::Object object = Napi::Object::New(env);
+        for (uint32_t ii = 0; ii < length && !reader.failed; ++ii) {
+          std::string key = reader.ReadString();
+          object.Set(key, ReadValue(env, replayer));
+        };
+        return object;
+      }
+      case kValueWrapped: {
+        uint32_t id = reader.Read<uint32_t>();
+        if (id >= replayer.objects.size() || replayer.objects[id].IsEmpty()) break;
+        replayer.lastObjectId = id;
+        return replayer.objects[id].Value();
+      }
+    };
+    reader.failed = true;
+    return env.Undefined();
+  };
+
+  static Napi::Value CallObjectMethod(Napi::Object object, const char* name, const std::vector<napi_value>& args) {
+    return object.Get(name).As<Napi::Function>().Call(object, args);
+  };
+
+  Napi::Value ReplayCapture(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (!info[0].IsObject() || !info[0].As<Napi::Object>().InstanceOf(GPUDevice::constructor.Value())) {
+      Napi::TypeError::New(env, "Expected 'GPUDevice' for argument 1").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Replayer replayer;
+    Reader& reader = replayer.reader;
+    if (info[1].IsArrayBuffer()) {
+      Napi::ArrayBuffer buffer = info[1].As<Napi::ArrayBuffer>();
+      reader.data = reinterpret_cast<const uint8_t*>(buffer.Data());
+      reader.size = buffer.ByteLength();
+    }
+    else if (info[1].IsTypedArray()) {
+      Napi::TypedArray array = info[1].As<Napi::TypedArray>();
+      reader.data = reinterpret_cast<const uint8_t*>(array.ArrayBuffer().Data()) + array.ByteOffset();
+      reader.size = array.ByteLength();
+    }
+    else {
+      Napi::TypeError::New(env, "Expected 'ArrayBuffer' or 'ArrayBufferView' for argument 2").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    char magic[sizeof(kMagic)] = {};
+    for (size_t ii = 0; ii < sizeof(kMagic); ++ii) magic[ii] = reader.Read<char>();
+    if (memcmp(magic, kMagic, sizeof(kMagic)) != 0 || reader.Read<uint32_t>() != kVersion) {
+      Napi::Error::New(env, "Invalid or unsupported capture").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    replayer.device = info[0].As<Napi::Object>();
+    FrameStats::Stats& frameStats = *Napi::ObjectWrap<GPUDevice>::Unwrap(replayer.device)->frameStats;
+    replayer.noop = Napi::Persistent(Napi::Function::New(env, [](const Napi::CallbackInfo& info) -> Napi::Value {
+      return info.Env().Undefined();
+    }));
+
+    uint32_t callIndex = 0;
+    uint32_t frames = 0;
+    // the result of the last call, until its objects got linked by a result record
+    Napi::Reference<Napi::Value> lastResult;
+    uint32_t lastResultIndex = 0;
+
+    uint64_t start = Profiler::Now();
+    while (!reader.failed && reader.offset < reader.size) {
+      Napi::HandleScope scope(env);
+      switch (reader.Read<uint8_t>()) {
+        case kRecordMethod: {
+          uint32_t id = reader.Read<uint32_t>();
+          std::string name = reader.ReadString();
+          size_t separator = name.find('.');
+          if (reader.failed || separator == std::string::npos) {
+            reader.failed = true;
+            break;
+          }
+          if (id >= replayer.methods.size()) replayer.methods.resize(id + 1);
+          replayer.methods[id].className = name.substr(0, separator);
+          replayer.methods[id].name = name.substr(separator + 1);
+        } break;
+        case kRecordExternal: {
+          uint32_t id = reader.Read<uint32_t>();
+          std::string className = reader.ReadString();
+          if (reader.failed) break;
+          if (className == "GPUDevice") {
+            SetObject(replayer, id, replayer.device);
+          }
+          else if (className == "GPUQueue") {
+            Napi::Value queue = CallObjectMethod(replayer.device, "getQueue", {});
+            if (env.IsExceptionPending()) return env.Undefined();
+            SetObject(replayer, id, queue.As<Napi::Object>());
+          }
+          else {
+            std::string message = "Capture references a '" + className + "' which was created before capturing started";
+            Napi::Error::New(env, message).ThrowAsJavaScriptException();
+            return env.Undefined();
+          }
+        } break;
+        case kRecordCall: {
+          uint32_t methodId = reader.Read<uint32_t>();
+          Napi::Value self = ReadValue(env, replayer);
+          uint32_t selfId = replayer.lastObjectId;
+          uint32_t argc = reader.Read<uint32_t>();
+          std::vector<napi_value> args;
+          for (uint32_t ii = 0; ii < argc && !reader.failed; ++ii) args.push_back(ReadValue(env, replayer));
+          if (reader.failed || methodId >= replayer.methods.size() || !self.IsObject()) {
+            reader.failed = true;
+            break;
+          }
+          Napi::Object object = self.As<Napi::Object>();
+          ReplayMethod& method = replayer.methods[methodId];
+          Napi::Value result = env.Undefined();
+          if (method.className == "GPUSwapChain") {
+            // 'object' is the offscreen texture of the swapchain
+            if (method.name == "getCurrentTextureView") {
+              Napi::Object descriptor = Napi::Object::New(env);
+              descriptor.Set("format", Napi::String::New(env, replayer.swapChainFormats[selfId]));
+              result = CallObjectMethod(object, "createView", { descriptor });
+            }
+            else if (method.name == "present") {
+              FrameStats::Present(frameStats);
+              frames++;
+            }
+          }
+          // presents the offscreen textures of all swapchains
+          else if (method.className == "GPUDevice" && method.name == "presentAll") {
+            FrameStats::Present(frameStats);
+            frames++;
+          }
+          else {
+            Napi::Value fn = object.Get(method.name);
+            if (!fn.IsFunction()) {
+              std::string message = "Capture calls unknown method '" + method.className + "." + method.name + "'";
+              Napi::Error::New(env, message).ThrowAsJavaScriptException();
+              return env.Undefined();
+            }
+            result = fn.As<Napi::Function>().Call(object, args);
+          }
+          if (env.IsExceptionPending()) return env.Undefined();
+          lastResultIndex = callIndex++;
+          lastResult = result.IsObject() ? Napi::Persistent(result) : Napi::Reference<Napi::Value>();
+        } break;
+        case kRecordResult: {
+          uint32_t index = reader.Read<uint32_t>();
+          uint32_t count = reader.Read<uint32_t>();
+          if (reader.failed || index != lastResultIndex || lastResult.IsEmpty()) {
+            reader.failed = true;
+            break;
+          }
+          std::vector<Napi::Object> results;
+          CollectResultObjects(env, lastResult.Value(), results);
+          if (results.size() != count) {
+            reader.failed = true;
+            break;
+          }
+          for (uint32_t ii = 0; ii < count; ++ii) SetObject(replayer, reader.Read<uint32_t>(), results[ii]);
+          lastResult.Reset();
+        } break;
+        case kRecordContents: {
+          uint32_t id = reader.Read<uint32_t>();
+          uint64_t length = 0;
+          const uint8_t* bytes = reader.ReadBytes(length);
+          if (reader.failed || id >= replayer.objects.size() || replayer.objects[id].IsEmpty()) {
+            reader.failed = true;
+            break;
+          }
+          GPUBuffer* buffer = Napi::ObjectWrap<GPUBuffer>::Unwrap(replayer.objects[id].Value());
+          if (buffer->mappedData != nullptr) {
+            memcpy(buffer->mappedData, bytes, std::min(length, buffer->mappedLength));
+          }
+        } break;
+        case kRecordSwapChain: {
+          uint32_t id = reader.Read<uint32_t>();
+          uint32_t width = reader.Read<uint32_t>();
+          uint32_t height = reader.Read<uint32_t>();
+          std::string format = reader.ReadString();
+          uint32_t usage = reader.Read<uint32_t>();
+          if (reader.failed) break;
+          Napi::Object size = Napi::Object::New(env);
+          size.Set("width", Napi::Number::New(env, width));
+          size.Set("height", Napi::Number::New(env, height));
+          size.Set("depth", Napi::Number::New(env, 1));
+          Napi::Object descriptor = Napi::Object::New(env);
+          descriptor.Set("size", size);
+          descriptor.Set("arrayLayerCount", Napi::Number::New(env, 1));
+          descriptor.Set("mipLevelCount", Napi::Number::New(env, 1));
+          descriptor.Set("sampleCount", Napi::Number::New(env, 1));
+          descriptor.Set("dimension", Napi::String::New(env, "2d"));
+          descriptor.Set("format", Napi::String::New(env, format));
+          descriptor.Set("usage", Napi::Number::New(env, usage | WGPUTextureUsage_OutputAttachment));
+          Napi::Value texture = CallObjectMethod(replayer.device, "createTexture", { descriptor });
+          if (env.IsExceptionPending()) return env.Undefined();
+          SetObject(replayer, id, texture.As<Napi::Object>());
+          replayer.swapChainFormats[id] = format;
+        } break;
+        default: {
+          reader.failed = true;
+        } break;
+      };
+    };
+    uint64_t end = Profiler::Now();
+
+    if (reader.failed) {
+      Napi::Error::New(env, "Invalid capture").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("calls", Napi::Number::New(env, callIndex));
+    out.Set("frames", Napi::Number::New(env, frames));
+    // in milliseconds
+    out.Set("time", Napi::Number::New(env, (end - start) * 1e-6));
+    return out;
+  };
+
+}
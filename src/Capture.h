@@ -0,0 +1,78 @@
+#ifndef __CAPTURE_H__
+#define __CAPTURE_H__
+
+#define NAPI_EXPERIMENTAL
+#include <napi.h>
+
+#include <string>
+#include <cstdint>
+
+// serializes all calls made through the bindings into a compact binary trace,
+// which can be re-issued against another device by the native replayer
+//
+// layout: 'WGPUCAPT', u32 version, followed by a stream of records
+//   Method    u32 methodId, string name ("Class.method")
+//   External  u32 objectId, string className - an object created before capturing
+//   Call      u32 methodId, value this, u32 argc, value args[argc]
+//   Result    u32 callIndex, u32 count, u32 objectIds[count]
+//   Contents  u32 bufferId, bytes - mapped memory of a buffer right before unmap
+//   SwapChain u32 objectId, u32 width, u32 height, string format, u32 usage
+// strings and bytes are prefixed with their u64 length
+namespace Capture {
+
+  const uint32_t kVersion = 1;
+
+  enum RecordType : uint8_t {
+    kRecordMethod = 1,
+    kRecordExternal,
+    kRecordCall,
+    kRecordResult,
+    kRecordContents,
+    kRecordSwapChain
+  };
+
+  enum ValueType : uint8_t {
+    kValueUndefined = 0,
+    kValueNull,
+    kValueFalse,
+    kValueTrue,
+    kValueNumber,
+    kValueBigInt,
+    kValueString,
+    kValueFunction,
+    kValueArrayBuffer,
+    // u8 napi_typedarray_type, bytes
+    kValueTypedArray,
+    // u32 count, values
+    kValueArray,
+    // u32 count, (string key, value) pairs
+    kValueObject,
+    // u32 objectId
+    kValueWrapped
+  };
+
+  extern bool enabled;
+
+  inline bool IsEnabled() {
+    return enabled;
+  };
+
+  // records a single bound method call, the result is
+  // linked to the call once the native method returned
+  class ScopedCall {
+    public:
+      ScopedCall(const Napi::CallbackInfo& info, const std::string& name);
+      void SetResult(const Napi::Value& result);
+    private:
+      enum Mode : uint8_t { kSkip, kCall, kSwapChain };
+      Mode mode = kSkip;
+      uint32_t index = 0;
+  };
+
+  Napi::Value StartCapture(const Napi::CallbackInfo& info);
+  Napi::Value StopCapture(const Napi::CallbackInfo& info);
+  Napi::Value ReplayCapture(const Napi::CallbackInfo& info);
+
+}
+
+#endif
@@ -0,0 +1,16 @@
+#include "DawnProcs.h"
+
+namespace DawnProcs {
+
+  DawnProcTable native = {};
+
+  static bool initialized = false;
+
+  void Initialize() {
+    if (initialized) return;
+    native = dawn_native::GetProcs();
+    dawnProcSetProcs(&native);
+    initialized = true;
+  };
+
+}
@@ -0,0 +1,26 @@
+#ifndef __DAWN_PROCS_H__
+#define __DAWN_PROCS_H__
+
+#include <dawn/dawn_proc.h>
+#include <dawn_native/DawnNative.h>
+
+// the entry points of dawn_native
+// when built with 'DAWN_NATIVE_PROCS', the generated pass encoder procs call them
+// directly, instead of going through the exported 'wgpu*' trampolines of dawn_proc
+// all other calls still use dawn_proc, which gets the same table installed
+namespace DawnProcs {
+
+  extern DawnProcTable native;
+
+#ifdef DAWN_NATIVE_PROCS
+  const char* const kMode = "native";
+#else
+  const char* const kMode = "proc";
+#endif
+
+  // only the first call has an effect
+  void Initialize();
+
+}
+
+#endif
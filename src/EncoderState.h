@@ -0,0 +1,82 @@
+#ifndef __GPU_ENCODER_STATE_H__
+#define __GPU_ENCODER_STATE_H__
+
+#include <dawn/webgpu.h>
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+// tracks the state currently bound to a pass or bundle encoder,
+// so that redundant sets don't get forwarded to dawn
+// each method returns true if the state changed and has to be set
+class EncoderState {
+
+  public:
+
+    bool setPipeline(const void* pipeline) {
+      if (pipeline == this->pipeline) return false;
+      this->pipeline = pipeline;
+      return true;
+    };
+
+    // out of range indices aren't tracked, dawn reports them as validation errors
+    bool setBindGroup(uint32_t index, WGPUBindGroup group, const std::vector<uint32_t>& dynamicOffsets) {
+      if (index >= kMaxBindGroups) return true;
+      BindGroupState& state = this->bindGroups[index];
+      if (state.group == group && state.dynamicOffsets == dynamicOffsets) return false;
+      state.group = group;
+      state.dynamicOffsets = dynamicOffsets;
+      return true;
+    };
+
+    bool setVertexBuffer(uint32_t slot, WGPUBuffer buffer, uint64_t offset, uint64_t size) {
+      if (slot >= kMaxVertexBuffers) return true;
+      BufferState& state = this->vertexBuffers[slot];
+      if (state.buffer == buffer && state.offset == offset && state.size == size) return false;
+      state = { buffer, offset, size };
+      return true;
+    };
+
+    bool setIndexBuffer(WGPUBuffer buffer, uint64_t offset, uint64_t size) {
+      BufferState& state = this->indexBuffer;
+      if (state.buffer == buffer && state.offset == offset && state.size == size) return false;
+      state = { buffer, offset, size };
+      return true;
+    };
+
+    // e.g. after executing bundles, which leaves the pass state undefined
+    void reset() {
+      this->pipeline = nullptr;
+      this->bindGroups.fill(BindGroupState());
+      this->vertexBuffers.fill(BufferState());
+      this->indexBuffer = BufferState();
+    };
+
+  private:
+
+    // dawn's limits, see 'kMaxBindGroups' and 'kMaxVertexBuffers' in dawn_native
+    static const uint32_t kMaxBindGroups = 4;
+    static const uint32_t kMaxVertexBuffers = 16;
+
+    struct BindGroupState {
+      WGPUBindGroup group = nullptr;
+      std::vector<uint32_t> dynamicOffsets;
+    };
+
+    struct BufferState {
+      WGPUBuffer buffer = nullptr;
+      uint64_t offset = 0;
+      uint64_t size = 0;
+    };
+
+    // dawn keeps a reference to all objects recorded into an encoder,
+    // so a handle can't get reused for a different object while it is bound
+    const void* pipeline = nullptr;
+    std::array<BindGroupState, kMaxBindGroups> bindGroups;
+    std::array<BufferState, kMaxVertexBuffers> vertexBuffers;
+    BufferState indexBuffer;
+
+};
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef __EVENT_QUEUE_H__
+#define __EVENT_QUEUE_H__
+
+#define NAPI_EXPERIMENTAL
+#include <napi.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+// ring buffer of fixed-size input event records, the memory is
+// an ArrayBuffer, so JS can read the records without any allocation
+//
+// layout: Header, followed by 'capacity' Records
+// drain() publishes the records written since the last drain as a batch,
+// which starts at record 'header.start' and wraps around at 'header.capacity'
+// the slots of a batch are only reused after the next drain
+class EventQueue {
+
+  public:
+
+    // keep in sync with 'WebGPUWindow.EventType' in index.js
+    enum Type : uint32_t {
+      kResize = 1,
+      kFocus,
+      kClose,
+      kKeyDown,
+      kKeyUp,
+      kMouseMove,
+      kMouseWheel,
+      kMouseDown,
+      kMouseUp,
+      kDrop
+    };
+
+    struct Header {
+      uint32_t start;
+      uint32_t capacity;
+      // events which got lost, because the queue wasn't drained in time
+      uint32_t dropped;
+      uint32_t recordSize;
+    };
+
+    // resize:     x, y = width, height
+    // focus:      code = focused
+    // key:        code = keyCode, mods
+    // mousemove:  x, y, deltaX, deltaY = movement
+    // mousewheel: x, y, deltaX, deltaY
+    // mousebutton: code = button, mods, x, y
+    // drop:       code = path count, the paths are passed to 'ondrop'
+    struct Record {
+      uint32_t type;
+      uint32_t code;
+      uint32_t mods;
+      uint32_t reserved;
+      double x;
+      double y;
+      double deltaX;
+      double deltaY;
+    };
+
+    EventQueue(Napi::Env env, uint32_t capacity) : capacity(capacity) {
+      Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(env, sizeof(Header) + capacity * sizeof(Record));
+      this->buffer.Reset(buffer, 1);
+      uint8_t* data = reinterpret_cast<uint8_t*>(buffer.Data());
+      memset(data, 0, buffer.ByteLength());
+      this->header = reinterpret_cast<Header*>(data);
+      this->records = reinterpret_cast<Record*>(data + sizeof(Header));
+      this->header->capacity = capacity;
+      this->header->recordSize = sizeof(Record);
+    };
+
+    ~EventQueue() {
+      this->buffer.Reset();
+    };
+
+    // returns false if the queue is full
+    bool push(const Record& record) {
+      uint64_t head = this->head.load(std::memory_order_relaxed);
+      if (head - this->tail.load(std::memory_order_acquire) >= this->capacity) {
+        this->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      this->records[head % this->capacity] = record;
+      this->head.store(head + 1, std::memory_order_release);
+      return true;
+    };
+
+    // releases the previous batch and returns the amount of records in the next one
+    uint32_t drain() {
+      uint64_t head = this->head.load(std::memory_order_acquire);
+      this->tail.store(this->batchEnd, std::memory_order_release);
+      this->header->start = static_cast<uint32_t>(this->batchEnd % this->capacity);
+      this->header->dropped = this->dropped.load(std::memory_order_relaxed);
+      uint32_t count = static_cast<uint32_t>(head - this->batchEnd);
+      this->batchEnd = head;
+      return count;
+    };
+
+    Napi::ObjectReference buffer;
+
+  private:
+    uint32_t capacity;
+    Header* header = nullptr;
+    Record* records = nullptr;
+    // written by the producer, and the consumer respectively
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    std::atomic<uint32_t> dropped{0};
+    uint64_t batchEnd = 0;
+
+};
+
+#endif
@@ -0,0 +1,51 @@
+#include "FrameStats.h"
+
+namespace FrameStats {
+
+  static uint64_t Take(std::atomic<uint64_t>& counter) {
+    return counter.exchange(0, std::memory_order_relaxed);
+  };
+
+  void Present(Stats& stats) {
+    Counters& counters = stats.counters;
+    Snapshot& lastFrame = stats.lastFrame;
+    lastFrame.draws = Take(counters.draws);
+    lastFrame.dispatches = Take(counters.dispatches);
+    lastFrame.bindGroupSets = Take(counters.bindGroupSets);
+    lastFrame.pipelineSwitches = Take(counters.pipelineSwitches);
+    lastFrame.elidedPipelineSwitches = Take(counters.elidedPipelineSwitches);
+    lastFrame.elidedBindGroupSets = Take(counters.elidedBindGroupSets);
+    lastFrame.elidedVertexBufferSets = Take(counters.elidedVertexBufferSets);
+    lastFrame.elidedIndexBufferSets = Take(counters.elidedIndexBufferSets);
+    lastFrame.bufferBytesUploaded = Take(counters.bufferBytesUploaded);
+    lastFrame.commandBuffersSubmitted = Take(counters.commandBuffersSubmitted);
+    lastFrame.queueSubmits = Take(counters.queueSubmits);
+    lastFrame.submitsCoalesced = Take(counters.submitsCoalesced);
+    lastFrame.objectsCreated = Take(counters.objectsCreated);
+    lastFrame.objectsDestroyed = Take(counters.objectsDestroyed);
+    lastFrame.decodeTime = Take(counters.decodeTime);
+  };
+
+  Napi::Object GetLastFrame(Napi::Env env, const Stats& stats) {
+    const Snapshot& lastFrame = stats.lastFrame;
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("draws", Napi::Number::New(env, static_cast<double>(lastFrame.draws)));
+    out.Set("dispatches", Napi::Number::New(env, static_cast<double>(lastFrame.dispatches)));
+    out.Set("bindGroupSets", Napi::Number::New(env, static_cast<double>(lastFrame.bindGroupSets)));
+    out.Set("pipelineSwitches", Napi::Number::New(env, static_cast<double>(lastFrame.pipelineSwitches)));
+    out.Set("elidedPipelineSwitches", Napi::Number::New(env, static_cast<double>(lastFrame.elidedPipelineSwitches)));
+    out.Set("elidedBindGroupSets", Napi::Number::New(env, static_cast<double>(lastFrame.elidedBindGroupSets)));
+    out.Set("elidedVertexBufferSets", Napi::Number::New(env, static_cast<double>(lastFrame.elidedVertexBufferSets)));
+    out.Set("elidedIndexBufferSets", Napi::Number::New(env, static_cast<double>(lastFrame.elidedIndexBufferSets)));
+    out.Set("bufferBytesUploaded", Napi::Number::New(env, static_cast<double>(lastFrame.bufferBytesUploaded)));
+    out.Set("commandBuffersSubmitted", Napi::Number::New(env, static_cast<double>(lastFrame.commandBuffersSubmitted)));
+    out.Set("queueSubmits", Napi::Number::New(env, static_cast<double>(lastFrame.queueSubmits)));
+    out.Set("submitsCoalesced", Napi::Number::New(env, static_cast<double>(lastFrame.submitsCoalesced)));
+    out.Set("objectsCreated", Napi::Number::New(env, static_cast<double>(lastFrame.objectsCreated)));
+    out.Set("objectsDestroyed", Napi::Number::New(env, static_cast<double>(lastFrame.objectsDestroyed)));
+    // in milliseconds
+    out.Set("decodeTime", Napi::Number::New(env, lastFrame.decodeTime * 1e-6));
+    return out;
+  };
+
+}
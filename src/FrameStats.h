@@ -0,0 +1,91 @@
+#ifndef __FRAME_STATS_H__
+#define __FRAME_STATS_H__
+
+#define NAPI_EXPERIMENTAL
+#include <napi.h>
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// per-device counters of the current frame, these get snapshotted and reset
+// each time the device ends a frame (swapchain present, presentAll, endUniformFrame)
+namespace FrameStats {
+
+  struct Counters {
+    std::atomic<uint64_t> draws{0};
+    std::atomic<uint64_t> dispatches{0};
+    std::atomic<uint64_t> bindGroupSets{0};
+    std::atomic<uint64_t> pipelineSwitches{0};
+    // redundant sets which weren't forwarded to dawn
+    std::atomic<uint64_t> elidedPipelineSwitches{0};
+    std::atomic<uint64_t> elidedBindGroupSets{0};
+    std::atomic<uint64_t> elidedVertexBufferSets{0};
+    std::atomic<uint64_t> elidedIndexBufferSets{0};
+    std::atomic<uint64_t> bufferBytesUploaded{0};
+    std::atomic<uint64_t> commandBuffersSubmitted{0};
+    // actual queue submits, and submits which got merged into them in deferred mode
+    std::atomic<uint64_t> queueSubmits{0};
+    std::atomic<uint64_t> submitsCoalesced{0};
+    std::atomic<uint64_t> objectsCreated{0};
+    std::atomic<uint64_t> objectsDestroyed{0};
+    // in nanoseconds
+    std::atomic<uint64_t> decodeTime{0};
+  };
+
+  struct Snapshot {
+    uint64_t draws = 0;
+    uint64_t dispatches = 0;
+    uint64_t bindGroupSets = 0;
+    uint64_t pipelineSwitches = 0;
+    uint64_t elidedPipelineSwitches = 0;
+    uint64_t elidedBindGroupSets = 0;
+    uint64_t elidedVertexBufferSets = 0;
+    uint64_t elidedIndexBufferSets = 0;
+    uint64_t bufferBytesUploaded = 0;
+    uint64_t commandBuffersSubmitted = 0;
+    uint64_t queueSubmits = 0;
+    uint64_t submitsCoalesced = 0;
+    uint64_t objectsCreated = 0;
+    uint64_t objectsDestroyed = 0;
+    uint64_t decodeTime = 0;
+  };
+
+  // owned by a device, shared with its objects since these
+  // can get finalized after the device
+  struct Stats {
+    Counters counters;
+    Snapshot lastFrame;
+  };
+
+  inline void Increment(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+    counter.fetch_add(value, std::memory_order_relaxed);
+  };
+
+  // ends the current frame
+  void Present(Stats& stats);
+
+  // returns the counters of the last frame
+  Napi::Object GetLastFrame(Napi::Env env, const Stats& stats);
+
+  // counts an object as created on the stats of its device,
+  // and as destroyed once the object gets finalized
+  class Tracker {
+    public:
+      ~Tracker() {
+        if (this->stats) Increment(this->stats->counters.objectsDestroyed);
+      };
+      void track(const std::shared_ptr<Stats>& stats) {
+        this->stats = stats;
+        Increment(stats->counters.objectsCreated);
+      };
+      Counters& counters() {
+        return this->stats->counters;
+      };
+    private:
+      std::shared_ptr<Stats> stats;
+  };
+
+}
+
+#endif
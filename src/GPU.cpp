@@ -1,5 +1,7 @@
 #include "GPU.h"
 #include "GPUAdapter.h"
+#include "DawnProcs.h"
+#include "PackedDescriptors.h"
 
 std::string platform = "";
 
@@ -36,9 +38,63 @@ Napi::Object GPU::Initialize(Napi::Env env, Napi::Object exports) {
       &GPU::requestAdapter,
       napi_enumerable
     ),
+    StaticMethod(
+      "getProfile",
+      &Profiler::GetProfile,
+      napi_enumerable
+    ),
+    StaticMethod(
+      "resetProfile",
+      &Profiler::ResetProfile,
+      napi_enumerable
+    ),
+    StaticMethod(
+      "enableProfiling",
+      &Profiler::EnableProfiling,
+      napi_enumerable
+    ),
+    StaticMethod(
+      "startTracing",
+      &Tracer::StartTracing,
+      napi_enumerable
+    ),
+    StaticMethod(
+      "stopTracing",
+      &Tracer::StopTracing,
+      napi_enumerable
+    ),
+    StaticMethod(
+      "getTrace",
+      &Tracer::GetTrace,
+      napi_enumerable
+    ),
+    StaticMethod(
+      "startCapture",
+      &Capture::StartCapture,
+      napi_enumerable
+    ),
+    StaticMethod(
+      "stopCapture",
+      &Capture::StopCapture,
+      napi_enumerable
+    ),
+    StaticMethod(
+      "replayCapture",
+      &Capture::ReplayCapture,
+      napi_enumerable
+    ),
+    StaticValue(
+      "dawnProcs",
+      Napi::String::New(env, DawnProcs::kMode),
+      napi_enumerable
+    ),
     StaticMethod(
       "$setPlatform",
       &SetPlatform
+    ),
+    StaticMethod(
+      "$setMemoryLayoutScratch",
+      &PackedDescriptors::SetScratch
     )
   });
   constructor = Napi::Persistent(func);
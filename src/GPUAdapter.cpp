@@ -9,11 +9,18 @@ GPUAdapter::GPUAdapter(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUAda
   if (info[0].IsObject()) {
     // ignore powerPreference
     Napi::Object obj = info[0].As<Napi::Object>();
-    if (!obj.Has("window")) {
+    // the null backend can run headless without a window
+    bool isHeadless = (
+      obj.Has("preferredBackend") &&
+      obj.Get("preferredBackend").IsString() &&
+      obj.Get("preferredBackend").ToString().Utf8Value() == "Null"
+    );
+    if (obj.Has("window")) {
+      this->window.Reset(obj.Get("window").As<Napi::Object>(), 1);
+    } else if (!isHeadless) {
       Napi::Error::New(env, "Expected 'WebGPUWindow' in 'GPURequestAdapterOptions.window'").ThrowAsJavaScriptException();
       return;
     }
-    this->window.Reset(obj.Get("window").As<Napi::Object>(), 1);
   } else {
     Napi::Error::New(env, "Expected 'Object' for argument 1 in 'requestAdapter'").ThrowAsJavaScriptException();
     return;
@@ -87,11 +94,19 @@ dawn_native::Adapter GPUAdapter::createAdapter(const Napi::CallbackInfo& info) {
         if (preferredBackend == "Vulkan" && (platform == "win32" || platform == "linux")) {
           return adapter.GetBackendType() == dawn_native::BackendType::Vulkan;
         }
+        if (preferredBackend == "Null") {
+          return adapter.GetBackendType() == dawn_native::BackendType::Null;
+        }
         return false;
       }
     );
     // we found a preferred adapter
     if (adapterIt != adapters.end()) return *adapterIt;
+    // headless devices cannot fall back to a windowed backend
+    if (preferredBackend == "Null") {
+      Napi::Error::New(env, "Null backend isn't available").ThrowAsJavaScriptException();
+      return nullptr;
+    }
     // otherwise we try to auto-choose a backend
   }
   // auto-choose backend
@@ -154,7 +169,8 @@ Napi::Object GPUAdapter::Initialize(Napi::Env env, Napi::Object exports) {
       nullptr,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUAdapter",
       "_requestDevice",
       &GPUAdapter::requestDevice,
       napi_enumerable
@@ -16,6 +16,7 @@ GPUBindGroup::GPUBindGroup(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GP
 
   this->device.Reset(info[0].As<Napi::Object>(), 1);
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPUBindGroupDescriptor(device, info[1].As<Napi::Value>());
 
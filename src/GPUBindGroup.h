@@ -16,6 +16,8 @@ class GPUBindGroup : public Napi::ObjectWrap<GPUBindGroup> {
     Napi::ObjectReference device;
 
     WGPUBindGroup instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
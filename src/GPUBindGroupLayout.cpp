@@ -10,6 +10,7 @@ GPUBindGroupLayout::GPUBindGroupLayout(const Napi::CallbackInfo& info) : Napi::O
 
   this->device.Reset(info[0].As<Napi::Object>(), 1);
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPUBindGroupLayoutDescriptor(device, info[1].As<Napi::Value>());
 
@@ -16,6 +16,8 @@ class GPUBindGroupLayout : public Napi::ObjectWrap<GPUBindGroupLayout> {
     Napi::ObjectReference device;
 
     WGPUBindGroupLayout instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
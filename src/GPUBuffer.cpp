@@ -17,11 +17,9 @@ struct BufferCallbackResult {
 GPUBuffer::GPUBuffer(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUBuffer>(info) {
   Napi::Env env = info.Env();
 
-  Napi::Array mappingArray = Napi::Array::New(env);
-  this->mappingArrayBuffers.Reset(mappingArray.As<Napi::Object>(), 1);
-
   this->device.Reset(info[0].As<Napi::Object>(), 1);
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPUBufferDescriptor(device, info[1].As<Napi::Value>());
 
@@ -29,34 +27,53 @@ GPUBuffer::GPUBuffer(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUBuffe
 }
 
 GPUBuffer::~GPUBuffer() {
+  // no JS heap access allowed while finalizing, only drop the references
+  for (napi_ref ref : this->mappingArrayBuffers) napi_delete_reference(this->Env(), ref);
   this->device.Reset();
-  this->mappingArrayBuffers.Reset();
   wgpuBufferRelease(this->instance);
 }
 
-void GPUBuffer::DestroyMappingArrayBuffers() {
-  Napi::Array mappingArray = this->mappingArrayBuffers.Value().As<Napi::Array>();
-  Napi::Env env = mappingArray.Env();
-  for (unsigned int ii = 0; ii < mappingArray.Length(); ++ii) {
-    Napi::ArrayBuffer ab = mappingArray.Get(ii).As<Napi::ArrayBuffer>();
-    napi_detach_arraybuffer(env, ab);
+Napi::ArrayBuffer GPUBuffer::CreateMappingArrayBuffer(Napi::Env env, uint64_t offset, uint64_t size) {
+  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(
+    env,
+    reinterpret_cast<uint8_t*>(this->mappedData) + offset,
+    size,
+    [](Napi::Env env, void* data) { }
+  );
+  // weak reference, the ArrayBuffer is only tracked to get detached on unmap
+  napi_ref ref = nullptr;
+  napi_create_reference(env, buffer, 0, &ref);
+  this->mappingArrayBuffers.push_back(ref);
+  return buffer;
+}
+
+void GPUBuffer::DestroyMappingArrayBuffers(Napi::Env env) {
+  for (napi_ref ref : this->mappingArrayBuffers) {
+    napi_value value = nullptr;
+    napi_get_reference_value(env, ref, &value);
+    // already garbage collected
+    if (value != nullptr) napi_detach_arraybuffer(env, value);
+    napi_delete_reference(env, ref);
   };
-  // reset to empty array
-  {
-    Napi::Array mappingArray = Napi::Array::New(env);
-    this->mappingArrayBuffers.Reset(mappingArray.As<Napi::Object>(), 1);
-  }
+  // keeps the capacity, so re-mapping doesn't allocate again
+  this->mappingArrayBuffers.clear();
+  this->mappedData = nullptr;
+  this->mappedLength = 0;
 }
 
 Napi::Value GPUBuffer::setSubData(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  uint64_t start = static_cast<uint64_t>(info[0].As<Napi::Number>().Uint32Value());
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+
+  uint64_t start = 0;
+  if (!device->decodeUint64(info[0], start, "offset")) return env.Undefined();
   size_t count = 0;
 
   uint8_t* data = getTypedArrayData<uint8_t>(info[1].As<Napi::Value>(), &count);
 
   wgpuBufferSetSubData(this->instance, start, count, data);
+  FrameStats::Increment(this->frameStats.counters().bufferBytesUploaded, count);
 
   return env.Undefined();
 }
@@ -64,6 +81,8 @@ Napi::Value GPUBuffer::setSubData(const Napi::CallbackInfo &info) {
 Napi::Value GPUBuffer::mapReadAsync(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
+  Tracer::ScopedEvent event("buffer", "MapReadAsync");
+
   bool hasCallback = info[0].IsFunction();
 
   Napi::Function callback;
@@ -71,6 +90,12 @@ Napi::Value GPUBuffer::mapReadAsync(const Napi::CallbackInfo &info) {
 
   BufferCallbackResult callbackResult;
 
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  WGPUDevice backendDevice = device->instance;
+
+  // commands using the buffer might still be deferred
+  device->flushPendingSubmits();
+
   wgpuBufferMapReadAsync(
     this->instance,
     [](WGPUBufferMapAsyncStatus status, const void* data, uint64_t dataLength, void* userdata) {
@@ -81,9 +106,6 @@ Napi::Value GPUBuffer::mapReadAsync(const Napi::CallbackInfo &info) {
     &callbackResult
   );
 
-  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
-  WGPUDevice backendDevice = device->instance;
-
   wgpuDeviceTick(backendDevice);
   if (!callbackResult.addr) {
     while (!callbackResult.addr) {
@@ -92,15 +114,10 @@ Napi::Value GPUBuffer::mapReadAsync(const Napi::CallbackInfo &info) {
     };
   }
 
-  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(
-    env,
-    callbackResult.addr,
-    callbackResult.length,
-    [](Napi::Env env, void* data) { }
-  );
+  this->mappedData = callbackResult.addr;
+  this->mappedLength = callbackResult.length;
 
-  Napi::Array mappingArray = this->mappingArrayBuffers.Value().As<Napi::Array>();
-  mappingArray[mappingArray.Length()] = buffer;
+  Napi::ArrayBuffer buffer = this->CreateMappingArrayBuffer(env, 0, callbackResult.length);
 
   if (hasCallback) callback.Call({ buffer });
 
@@ -110,9 +127,18 @@ Napi::Value GPUBuffer::mapReadAsync(const Napi::CallbackInfo &info) {
 Napi::Value GPUBuffer::mapWriteAsync(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
+  Tracer::ScopedEvent event("buffer", "MapWriteAsync");
+
   Napi::Function callback = info[0].As<Napi::Function>();
 
   BufferCallbackResult callbackResult;
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  WGPUDevice backendDevice = device->instance;
+
+  // commands using the buffer might still be deferred
+  device->flushPendingSubmits();
+
   wgpuBufferMapWriteAsync(
     this->instance,
     [](WGPUBufferMapAsyncStatus status, void* ptr, uint64_t dataLength, void* userdata) {
@@ -123,9 +149,6 @@ Napi::Value GPUBuffer::mapWriteAsync(const Napi::CallbackInfo &info) {
     &callbackResult
   );
 
-  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
-  WGPUDevice backendDevice = device->instance;
-
   wgpuDeviceTick(backendDevice);
   if (!callbackResult.addr) {
     while (!callbackResult.addr) {
@@ -134,31 +157,62 @@ Napi::Value GPUBuffer::mapWriteAsync(const Napi::CallbackInfo &info) {
     };
   }
 
-  Napi::ArrayBuffer buffer = Napi::ArrayBuffer::New(
-    env,
-    callbackResult.addr,
-    callbackResult.length,
-    [](Napi::Env env, void* data) { }
-  );
+  this->mappedData = callbackResult.addr;
+  this->mappedLength = callbackResult.length;
 
-  Napi::Array mappingArray = this->mappingArrayBuffers.Value().As<Napi::Array>();
-  mappingArray[mappingArray.Length()] = buffer;
+  Napi::ArrayBuffer buffer = this->CreateMappingArrayBuffer(env, 0, callbackResult.length);
 
   callback.Call({ buffer });
 
   return env.Undefined();
 }
 
+Napi::Value GPUBuffer::getMappedRange(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+
+  if (this->mappedData == nullptr) {
+    device->throwCallbackError(
+      Napi::String::New(env, "Error"),
+      Napi::String::New(env, "Buffer isn't mapped")
+    );
+    return env.Undefined();
+  }
+
+  uint64_t offset = 0;
+  if (!info[0].IsUndefined() && !device->decodeUint64(info[0], offset, "offset")) return env.Undefined();
+  uint64_t size = 0;
+  if (!info[1].IsUndefined()) {
+    if (!device->decodeUint64(info[1], size, "size")) return env.Undefined();
+  } else if (offset <= this->mappedLength) {
+    size = this->mappedLength - offset;
+  }
+
+  if (offset > this->mappedLength || size > this->mappedLength - offset) {
+    device->throwCallbackError(
+      Napi::String::New(env, "Range"),
+      Napi::String::New(env, "Mapped range is out of bounds")
+    );
+    return env.Undefined();
+  }
+
+  return this->CreateMappingArrayBuffer(env, offset, size);
+}
+
 Napi::Value GPUBuffer::unmap(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
-  this->DestroyMappingArrayBuffers();
+  this->DestroyMappingArrayBuffers(env);
   wgpuBufferUnmap(this->instance);
   return env.Undefined();
 }
 
 Napi::Value GPUBuffer::destroy(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
-  this->DestroyMappingArrayBuffers();
+  this->DestroyMappingArrayBuffers(env);
+  // deferred commands might still use the buffer
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  device->flushPendingSubmits();
   wgpuBufferDestroy(this->instance);
   return env.Undefined();
 }
@@ -166,27 +220,38 @@ Napi::Value GPUBuffer::destroy(const Napi::CallbackInfo &info) {
 Napi::Object GPUBuffer::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPUBuffer", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUBuffer",
       "setSubData",
       &GPUBuffer::setSubData,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUBuffer",
       "_mapReadAsync",
       &GPUBuffer::mapReadAsync,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUBuffer",
       "_mapWriteAsync",
       &GPUBuffer::mapWriteAsync,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUBuffer",
+      "getMappedRange",
+      &GPUBuffer::getMappedRange,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUBuffer",
       "unmap",
       &GPUBuffer::unmap,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUBuffer",
       "destroy",
       &GPUBuffer::destroy,
       napi_enumerable
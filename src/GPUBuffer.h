@@ -3,6 +3,8 @@
 
 #include "Base.h"
 
+#include <vector>
+
 class GPUBuffer : public Napi::ObjectWrap<GPUBuffer> {
 
   public:
@@ -18,6 +20,8 @@ class GPUBuffer : public Napi::ObjectWrap<GPUBuffer> {
     Napi::Value mapReadAsync(const Napi::CallbackInfo &info);
     Napi::Value mapWriteAsync(const Napi::CallbackInfo &info);
 
+    Napi::Value getMappedRange(const Napi::CallbackInfo &info);
+
     Napi::Value unmap(const Napi::CallbackInfo &info);
     Napi::Value destroy(const Napi::CallbackInfo &info);
 
@@ -25,13 +29,20 @@ class GPUBuffer : public Napi::ObjectWrap<GPUBuffer> {
 
     WGPUBuffer instance;
 
+    FrameStats::Tracker frameStats;
+
+    // the currently mapped memory of this buffer
+    void* mappedData = nullptr;
+    uint64_t mappedLength = 0;
+
   private:
     // ArrayBuffers created and returned in the mapping process get linked
-    // to this GPUBuffer - we keep track of them, since we have to detach them
-    // after this GPUBuffer got unmapped or destroyed
-    Napi::ObjectReference mappingArrayBuffers;
+    // to this GPUBuffer - we keep weak references to them, since we have to
+    // detach them after this GPUBuffer got unmapped or destroyed
+    std::vector<napi_ref> mappingArrayBuffers;
 
-    void DestroyMappingArrayBuffers();
+    Napi::ArrayBuffer CreateMappingArrayBuffer(Napi::Env env, uint64_t offset, uint64_t size);
+    void DestroyMappingArrayBuffers(Napi::Env env);
 };
 
 #endif
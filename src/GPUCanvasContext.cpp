@@ -32,17 +32,17 @@ Napi::Value GPUCanvasContext::getSwapChainPreferredFormat(const Napi::CallbackIn
   Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
 
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(info[0].As<Napi::Object>());
-  GPUAdapter* adapter = Napi::ObjectWrap<GPUAdapter>::Unwrap(device->adapter.Value());
-  WebGPUWindow* window = Napi::ObjectWrap<WebGPUWindow>::Unwrap(adapter->window.Value());
+  WebGPUWindow* window = Napi::ObjectWrap<WebGPUWindow>::Unwrap(this->window.Value());
+  BackendBinding* binding = window->getBinding(device);
 
   if (window->preferredSwapChainFormat == WGPUTextureFormat_Undefined) {
     WGPUSwapChainDescriptor descriptor;
     descriptor.nextInChain = nullptr;
     // returns always the same address, so we dont have to release this temp swapchain?
-    descriptor.implementation = device->binding->GetSwapChainImplementation();
+    descriptor.implementation = binding->GetSwapChainImplementation();
     WGPUSwapChain instance = wgpuDeviceCreateSwapChain(device->instance, nullptr, &descriptor);
-    glfwPollEvents();
-    window->preferredSwapChainFormat = device->binding->GetPreferredSwapChainTextureFormat();
+    WebGPUWindow::PollEvents();
+    window->preferredSwapChainFormat = binding->GetPreferredSwapChainTextureFormat();
   }
 
   std::string textureFormat = DescriptorDecoder::GPUTextureFormat(
@@ -56,12 +56,14 @@ Napi::Value GPUCanvasContext::getSwapChainPreferredFormat(const Napi::CallbackIn
 Napi::Object GPUCanvasContext::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPUCanvasContext", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCanvasContext",
       "configureSwapChain",
       &GPUCanvasContext::configureSwapChain,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCanvasContext",
       "getSwapChainPreferredFormat",
       &GPUCanvasContext::getSwapChainPreferredFormat,
       napi_enumerable
@@ -7,6 +7,7 @@ GPUCommandBuffer::GPUCommandBuffer(const Napi::CallbackInfo& info) : Napi::Objec
 }
 
 GPUCommandBuffer::~GPUCommandBuffer() {
+  for (GPUQueryResolve& resolve : this->queryResolves) wgpuBufferRelease(resolve.buffer);
   wgpuCommandBufferRelease(this->instance);
 }
 
@@ -2,6 +2,9 @@
 #define __GPU_COMMAND_BUFFER_H__
 
 #include "Base.h"
+#include "GPUQuerySet.h"
+
+#include <vector>
 
 class GPUCommandBuffer : public Napi::ObjectWrap<GPUCommandBuffer> {
 
@@ -14,6 +17,11 @@ class GPUCommandBuffer : public Napi::ObjectWrap<GPUCommandBuffer> {
     ~GPUCommandBuffer();
 
     WGPUCommandBuffer instance;
+
+    FrameStats::Tracker frameStats;
+
+    // written into their destination buffers on submit
+    std::vector<GPUQueryResolve> queryResolves;
   private:
 
 };
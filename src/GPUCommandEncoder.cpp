@@ -1,14 +1,18 @@
 #include "GPUCommandEncoder.h"
 #include "GPUDevice.h"
 #include "GPUBuffer.h"
+#include "GPUTexture.h"
 #include "GPUCommandBuffer.h"
 #include "GPURenderPassEncoder.h"
 #include "GPUComputePassEncoder.h"
 #include "GPURayTracingPassEncoder.h"
 #include "GPURayTracingAccelerationContainer.h"
+#include "ImageBitmap.h"
 
 #include "DescriptorDecoder.h"
 
+#include <vector>
+
 Napi::FunctionReference GPUCommandEncoder::constructor;
 
 GPUCommandEncoder::GPUCommandEncoder(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUCommandEncoder>(info) {
@@ -16,14 +20,18 @@ GPUCommandEncoder::GPUCommandEncoder(const Napi::CallbackInfo& info) : Napi::Obj
 
   this->device.Reset(info[0].As<Napi::Object>(), 1);
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPUCommandEncoderDescriptor(device, info[1].As<Napi::Value>());
 
   this->instance = wgpuDeviceCreateCommandEncoder(device->instance, &descriptor);
+
+  Tracer::AsyncBegin("gpu", "CommandEncoder", this->instance);
 }
 
 GPUCommandEncoder::~GPUCommandEncoder() {
   this->device.Reset();
+  for (GPUQueryResolve& resolve : this->queryResolves) wgpuBufferRelease(resolve.buffer);
   wgpuCommandEncoderRelease(this->instance);
 }
 
@@ -105,11 +113,16 @@ Napi::Value GPUCommandEncoder::copyBufferToBuffer(const Napi::CallbackInfo &info
   WGPUCommandEncoder commandEncoder = this->instance;
   WGPUBuffer source = Napi::ObjectWrap<GPUBuffer>::Unwrap(info[0].As<Napi::Object>())->instance;
 
-  uint64_t sourceOffset = static_cast<uint64_t>(info[1].As<Napi::Number>().Uint32Value());
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+
+  uint64_t sourceOffset = 0;
+  if (!device->decodeUint64(info[1], sourceOffset, "sourceOffset")) return env.Undefined();
 
   WGPUBuffer destination = Napi::ObjectWrap<GPUBuffer>::Unwrap(info[2].As<Napi::Object>())->instance;
-  uint64_t destinationOffset = static_cast<uint64_t>(info[3].As<Napi::Number>().Uint32Value());
-  uint64_t size = static_cast<uint64_t>(info[4].As<Napi::Number>().Uint32Value());
+  uint64_t destinationOffset = 0;
+  if (!device->decodeUint64(info[3], destinationOffset, "destinationOffset")) return env.Undefined();
+  uint64_t size = 0;
+  if (!device->decodeUint64(info[4], size, "size")) return env.Undefined();
 
   wgpuCommandEncoderCopyBufferToBuffer(commandEncoder, source, sourceOffset, destination, destinationOffset, size);
 
@@ -162,9 +175,103 @@ Napi::Value GPUCommandEncoder::copyImageBitmapToTexture(const Napi::CallbackInfo
   Napi::Env env = info.Env();
 
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
-  Napi::String type = Napi::String::New(env, "Type");
-  Napi::String message = Napi::String::New(env, "Unimplemented method 'GPUCommandEncoder::copyImageBitmapToTexture'");
-  device->throwCallbackError(type, message);
+
+  if (!info[0].IsObject() || !info[1].IsObject() || !info[2].IsObject()) {
+    Napi::String type = Napi::String::New(env, "Type");
+    Napi::String message = Napi::String::New(env, "Invalid Function Signature for 'GPUCommandEncoder::copyImageBitmapToTexture'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+
+  // source
+  Napi::Object sourceObject = info[0].As<Napi::Object>();
+  Napi::Value imageBitmapValue = sourceObject.Get("imageBitmap");
+  if (!imageBitmapValue.IsObject() || !imageBitmapValue.As<Napi::Object>().InstanceOf(ImageBitmap::constructor.Value())) {
+    Napi::String type = Napi::String::New(env, "Type");
+    Napi::String message = Napi::String::New(env, "Expected 'ImageBitmap' for 'GPUImageBitmapCopyView'.'imageBitmap'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+  ImageBitmap* imageBitmap = Napi::ObjectWrap<ImageBitmap>::Unwrap(imageBitmapValue.As<Napi::Object>());
+
+  uint32_t originX = 0;
+  uint32_t originY = 0;
+  if (sourceObject.Has("origin") && sourceObject.Get("origin").IsObject()) {
+    Napi::Object origin = sourceObject.Get("origin").As<Napi::Object>();
+    if (origin.Has("x")) originX = origin.Get("x").As<Napi::Number>().Uint32Value();
+    if (origin.Has("y")) originY = origin.Get("y").As<Napi::Number>().Uint32Value();
+  }
+
+  // destination
+  Napi::Object destinationObject = info[1].As<Napi::Object>();
+  Napi::Value textureValue = destinationObject.Get("texture");
+  if (!textureValue.IsObject() || !textureValue.As<Napi::Object>().InstanceOf(GPUTexture::constructor.Value())) {
+    Napi::String type = Napi::String::New(env, "Type");
+    Napi::String message = Napi::String::New(env, "Expected 'GPUTexture' for 'destination.texture' in 'GPUCommandEncoder::copyImageBitmapToTexture'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+  GPUTexture* texture = Napi::ObjectWrap<GPUTexture>::Unwrap(textureValue.As<Napi::Object>());
+
+  bool premultiplyAlpha = false;
+  if (destinationObject.Has("premultiplyAlpha")) {
+    premultiplyAlpha = destinationObject.Get("premultiplyAlpha").ToBoolean().Value();
+  }
+
+  auto destination = DescriptorDecoder::GPUTextureCopyView(device, info[1].As<Napi::Value>());
+  WGPUExtent3D copySize = DescriptorDecoder::DecodeGPUExtent3D(device, info[2].As<Napi::Value>());
+  copySize.depth = 1;
+
+  if (
+    static_cast<uint64_t>(originX) + copySize.width > imageBitmap->width ||
+    static_cast<uint64_t>(originY) + copySize.height > imageBitmap->height
+  ) {
+    Napi::String type = Napi::String::New(env, "Range");
+    Napi::String message = Napi::String::New(env, "Copy size exceeds the bounds of the 'ImageBitmap'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+
+  uint64_t bytesPerRow = alignTo(static_cast<uint64_t>(copySize.width) * 4, kCopyRowPitchAlignment);
+  uint64_t stagingSize = bytesPerRow * copySize.height;
+  if (stagingSize == 0) return env.Undefined();
+
+  std::vector<uint8_t> staging(stagingSize);
+  bool converted = imageBitmap->convertTo(
+    texture->format,
+    premultiplyAlpha,
+    originX,
+    originY,
+    copySize.width,
+    copySize.height,
+    staging.data(),
+    bytesPerRow
+  );
+  if (!converted) {
+    Napi::String type = Napi::String::New(env, "Type");
+    Napi::String message = Napi::String::New(env, "Unsupported destination texture format for 'copyImageBitmapToTexture'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+
+  // upload through a temporary buffer, the recorded copy keeps it alive
+  WGPUBufferDescriptor descriptor;
+  descriptor.nextInChain = nullptr;
+  descriptor.label = nullptr;
+  descriptor.usage = static_cast<WGPUBufferUsage>(WGPUBufferUsage_CopySrc | WGPUBufferUsage_CopyDst);
+  descriptor.size = stagingSize;
+  WGPUBuffer stagingBuffer = wgpuDeviceCreateBuffer(device->instance, &descriptor);
+  wgpuBufferSetSubData(stagingBuffer, 0, stagingSize, staging.data());
+
+  WGPUBufferCopyView source;
+  source.nextInChain = nullptr;
+  source.buffer = stagingBuffer;
+  source.offset = 0;
+  source.bytesPerRow = static_cast<uint32_t>(bytesPerRow);
+  source.rowsPerImage = copySize.height;
+
+  wgpuCommandEncoderCopyBufferToTexture(this->instance, &source, &destination, &copySize);
+  wgpuBufferRelease(stagingBuffer);
 
   return env.Undefined();
 }
@@ -172,8 +279,9 @@ Napi::Value GPUCommandEncoder::copyImageBitmapToTexture(const Napi::CallbackInfo
 Napi::Value GPUCommandEncoder::pushDebugGroup(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  const char* groupLabel = info[0].As<Napi::String>().Utf8Value().c_str();
-  wgpuCommandEncoderPushDebugGroup(this->instance, groupLabel);
+  std::string groupLabel = info[0].As<Napi::String>().Utf8Value();
+  wgpuCommandEncoderPushDebugGroup(this->instance, groupLabel.c_str());
+  Tracer::PushDebugGroup(reinterpret_cast<uint64_t>(this->instance), groupLabel);
 
   return env.Undefined();
 }
@@ -182,6 +290,7 @@ Napi::Value GPUCommandEncoder::popDebugGroup(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
   wgpuCommandEncoderPopDebugGroup(this->instance);
+  Tracer::PopDebugGroup(reinterpret_cast<uint64_t>(this->instance));
 
   return env.Undefined();
 }
@@ -189,8 +298,61 @@ Napi::Value GPUCommandEncoder::popDebugGroup(const Napi::CallbackInfo &info) {
 Napi::Value GPUCommandEncoder::insertDebugMarker(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  const char* groupLabel = info[0].As<Napi::String>().Utf8Value().c_str();
-  wgpuCommandEncoderInsertDebugMarker(this->instance, groupLabel);
+  std::string groupLabel = info[0].As<Napi::String>().Utf8Value();
+  wgpuCommandEncoderInsertDebugMarker(this->instance, groupLabel.c_str());
+
+  return env.Undefined();
+}
+
+Napi::Value GPUCommandEncoder::writeTimestamp(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+
+  GPUQuerySet* querySet = Napi::ObjectWrap<GPUQuerySet>::Unwrap(info[0].As<Napi::Object>());
+  uint32_t queryIndex = info[1].As<Napi::Number>().Uint32Value();
+
+  if (!querySet->writeTimestamp(queryIndex)) {
+    device->throwCallbackError(
+      Napi::String::New(env, "Range"),
+      Napi::String::New(env, "Query index is out of range")
+    );
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value GPUCommandEncoder::resolveQuerySet(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+
+  GPUQuerySet* querySet = Napi::ObjectWrap<GPUQuerySet>::Unwrap(info[0].As<Napi::Object>());
+  uint32_t firstQuery = info[1].As<Napi::Number>().Uint32Value();
+  uint32_t queryCount = info[2].As<Napi::Number>().Uint32Value();
+  GPUBuffer* destination = Napi::ObjectWrap<GPUBuffer>::Unwrap(info[3].As<Napi::Object>());
+  uint64_t destinationOffset = 0;
+  if (!device->decodeUint64(info[4], destinationOffset, "destinationOffset")) return env.Undefined();
+
+  if (static_cast<uint64_t>(firstQuery) + queryCount > querySet->values.size()) {
+    device->throwCallbackError(
+      Napi::String::New(env, "Range"),
+      Napi::String::New(env, "Query range is out of bounds")
+    );
+    return env.Undefined();
+  }
+
+  // the values are known at this point already, but only get
+  // written into the destination once the command buffer is submitted
+  GPUQueryResolve resolve;
+  resolve.buffer = destination->instance;
+  resolve.offset = destinationOffset;
+  resolve.values.assign(
+    querySet->values.begin() + firstQuery,
+    querySet->values.begin() + firstQuery + queryCount
+  );
+  wgpuBufferReference(resolve.buffer);
+  this->queryResolves.push_back(std::move(resolve));
 
   return env.Undefined();
 }
@@ -200,9 +362,15 @@ Napi::Value GPUCommandEncoder::finish(const Napi::CallbackInfo &info) {
 
   WGPUCommandBuffer buffer = wgpuCommandEncoderFinish(this->instance, nullptr);
 
+  Tracer::AsyncEnd("gpu", "CommandEncoder", this->instance);
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
   Napi::Object commandBuffer = GPUCommandBuffer::constructor.New({});
   GPUCommandBuffer* uwCommandBuffer = Napi::ObjectWrap<GPUCommandBuffer>::Unwrap(commandBuffer);
+  uwCommandBuffer->frameStats.track(device->frameStats);
   uwCommandBuffer->instance = buffer;
+  uwCommandBuffer->queryResolves = std::move(this->queryResolves);
+  this->queryResolves.clear();
 
   return commandBuffer;
 }
@@ -210,77 +378,104 @@ Napi::Value GPUCommandEncoder::finish(const Napi::CallbackInfo &info) {
 Napi::Object GPUCommandEncoder::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPUCommandEncoder", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "beginRenderPass",
       &GPUCommandEncoder::beginRenderPass,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "beginComputePass",
       &GPUCommandEncoder::beginComputePass,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "beginRayTracingPass",
       &GPUCommandEncoder::beginRayTracingPass,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "buildRayTracingAccelerationContainer",
       &GPUCommandEncoder::buildRayTracingAccelerationContainer,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "copyRayTracingAccelerationContainer",
       &GPUCommandEncoder::copyRayTracingAccelerationContainer,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "updateRayTracingAccelerationContainer",
       &GPUCommandEncoder::updateRayTracingAccelerationContainer,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "copyBufferToBuffer",
       &GPUCommandEncoder::copyBufferToBuffer,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "copyBufferToTexture",
       &GPUCommandEncoder::copyBufferToTexture,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "copyTextureToBuffer",
       &GPUCommandEncoder::copyTextureToBuffer,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "copyTextureToTexture",
       &GPUCommandEncoder::copyTextureToTexture,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "copyImageBitmapToTexture",
       &GPUCommandEncoder::copyImageBitmapToTexture,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "pushDebugGroup",
       &GPUCommandEncoder::pushDebugGroup,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "popDebugGroup",
       &GPUCommandEncoder::popDebugGroup,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "insertDebugMarker",
       &GPUCommandEncoder::insertDebugMarker,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
+      "writeTimestamp",
+      &GPUCommandEncoder::writeTimestamp,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
+      "resolveQuerySet",
+      &GPUCommandEncoder::resolveQuerySet,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUCommandEncoder",
       "finish",
       &GPUCommandEncoder::finish,
       napi_enumerable
@@ -2,6 +2,9 @@
 #define __GPU_COMMAND_ENCODER_H__
 
 #include "Base.h"
+#include "GPUQuerySet.h"
+
+#include <vector>
 
 class GPUCommandEncoder : public Napi::ObjectWrap<GPUCommandEncoder> {
 
@@ -31,11 +34,19 @@ class GPUCommandEncoder : public Napi::ObjectWrap<GPUCommandEncoder> {
     Napi::Value popDebugGroup(const Napi::CallbackInfo &info);
     Napi::Value insertDebugMarker(const Napi::CallbackInfo &info);
 
+    Napi::Value writeTimestamp(const Napi::CallbackInfo &info);
+    Napi::Value resolveQuerySet(const Napi::CallbackInfo &info);
+
     Napi::Value finish(const Napi::CallbackInfo &info);
 
     Napi::ObjectReference device;
 
     WGPUCommandEncoder instance;
+
+    FrameStats::Tracker frameStats;
+
+    // handed over to the command buffer in 'finish'
+    std::vector<GPUQueryResolve> queryResolves;
   private:
 
 };
@@ -16,6 +16,8 @@ class GPUComputePipeline : public Napi::ObjectWrap<GPUComputePipeline> {
     Napi::ObjectReference device;
 
     WGPUComputePipeline instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
@@ -1,9 +1,11 @@
 #include "GPUDevice.h"
 #include "GPUAdapter.h"
 #include "GPUQueue.h"
+#include "GPUSwapChain.h"
 #include "GPUBuffer.h"
 #include "GPUTexture.h"
 #include "GPUSampler.h"
+#include "GPUQuerySet.h"
 #include "GPUBindGroupLayout.h"
 #include "GPUPipelineLayout.h"
 #include "GPUBindGroup.h"
@@ -15,6 +17,7 @@
 #include "GPURayTracingAccelerationContainer.h"
 #include "GPURayTracingShaderBindingTable.h"
 #include "GPURayTracingPipeline.h"
+#include "DawnProcs.h"
 
 #include "WebGPUWindow.h"
 
@@ -49,6 +52,19 @@ GPUDevice::GPUDevice(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUDevic
     if (obj.Has(Napi::String::New(env, "limits"))) {
       this->limits.Reset(obj.Get("limits").As<Napi::Object>(), 1);
     }
+    if (obj.Has(Napi::String::New(env, "uniformRingSize"))) {
+      // the error callback isn't set up yet, so this throws directly
+      uint64_t size = 0;
+      if (
+        !getUint64Value(obj.Get("uniformRingSize"), size) ||
+        size == 0 ||
+        size > UINT64_MAX - (UniformRing::kAlignment - 1)
+      ) {
+        Napi::RangeError::New(env, "Expected a positive integer for 'uniformRingSize'").ThrowAsJavaScriptException();
+        return;
+      }
+      this->uniformRing.size = alignTo(std::max(size, UniformRing::kAlignment), UniformRing::kAlignment);
+    }
   }
 
   dawn_native::DeviceDescriptor desc = {};
@@ -61,10 +77,8 @@ GPUDevice::GPUDevice(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUDevic
     return;
   }
 
-  DawnProcTable procs = dawn_native::GetProcs();
-
-  dawnProcSetProcs(&procs);
-  procs.deviceSetUncapturedErrorCallback(
+  DawnProcs::Initialize();
+  DawnProcs::native.deviceSetUncapturedErrorCallback(
     this->instance,
     [](WGPUErrorType errorType, const char* message, void* devicePtr) {
       std::string type;
@@ -105,7 +119,9 @@ GPUDevice::~GPUDevice() {
   this->mainQueue.Reset();
   this->onErrorCallback.Reset();
 
-  delete this->binding;
+  if (this->ownsBinding) delete this->binding;
+  if (this->instance == nullptr) return;
+  for (WebGPUWindow* window : WebGPUWindow::windows) window->releaseBinding(this->instance);
   wgpuDeviceRelease(this->instance);
 }
 
@@ -113,10 +129,15 @@ BackendBinding* GPUDevice::createBinding(const Napi::CallbackInfo& info, WGPUDev
   Napi::Env env = info.Env();
 
   GPUAdapter* adapter = Napi::ObjectWrap<GPUAdapter>::Unwrap(this->adapter.Value());
-  WebGPUWindow* window = Napi::ObjectWrap<WebGPUWindow>::Unwrap(adapter->window.Value());
 
+  if (!adapter->window.IsEmpty()) {
+    return Napi::ObjectWrap<WebGPUWindow>::Unwrap(adapter->window.Value())->getBinding(this);
+  }
+
+  // headless adapters have no window
   dawn_native::BackendType backendType = adapter->instance.GetBackendType();
-  BackendBinding* binding = CreateBinding(backendType, window->instance, device);
+  BackendBinding* binding = CreateBinding(backendType, nullptr, device);
+  this->ownsBinding = true;
 
   return binding;
 }
@@ -151,16 +172,32 @@ void GPUDevice::SetOnErrorCallback(const Napi::CallbackInfo& info, const Napi::V
   this->onErrorCallback.Reset(value.As<Napi::Function>(), 1);
 }
 
+void GPUDevice::flushPendingSubmits() {
+  Napi::ObjectWrap<GPUQueue>::Unwrap(this->mainQueue.Value())->flushPendingSubmits();
+}
+
 void GPUDevice::throwCallbackError(const Napi::Value& type, const Napi::Value& msg) {
   Napi::Env env = type.Env();
   this->onErrorCallback.Call({ type, msg });
   nextJSProcessTick(env); // try to display the error immediately
 }
 
+bool GPUDevice::decodeUint64(const Napi::Value& value, uint64_t& out, const char* name) {
+  if (getUint64Value(value, out)) return true;
+  Napi::Env env = value.Env();
+  std::string message = "Expected a non-negative safe integer or a BigInt below 2^64 for '";
+  message += name;
+  message += "'";
+  this->throwCallbackError(Napi::String::New(env, "Range"), Napi::String::New(env, message));
+  return false;
+}
+
 Napi::Value GPUDevice::tick(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   wgpuDeviceTick(this->instance);
-  glfwPollEvents();
+  // headless devices have no window events to poll
+  GPUAdapter* adapter = Napi::ObjectWrap<GPUAdapter>::Unwrap(this->adapter.Value());
+  if (!adapter->window.IsEmpty()) WebGPUWindow::PollEvents();
   return env.Undefined();
 }
 
@@ -244,11 +281,21 @@ Napi::Value GPUDevice::createSampler(const Napi::CallbackInfo &info) {
   std::vector<napi_value> args = {
     info.This().As<Napi::Value>()
   };
-  if (info[0].IsObject()) args.push_back(info[0].As<Napi::Value>());
+  // descriptors can also be packed, see 'PackedDescriptors.h'
+  if (info[0].IsObject() || info[0].IsNumber()) args.push_back(info[0].As<Napi::Value>());
   Napi::Object sampler = GPUSampler::constructor.New(args);
   return sampler;
 }
 
+Napi::Value GPUDevice::createQuerySet(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  Napi::Object querySet = GPUQuerySet::constructor.New({
+    info.This().As<Napi::Value>(),
+    info[0].As<Napi::Value>()
+  });
+  return querySet;
+}
+
 Napi::Value GPUDevice::createBindGroupLayout(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   std::vector<napi_value> args = {
@@ -314,7 +361,8 @@ Napi::Value GPUDevice::createCommandEncoder(const Napi::CallbackInfo &info) {
   std::vector<napi_value> args = {
     info.This().As<Napi::Value>()
   };
-  if (info[0].IsObject()) args.push_back(info[0].As<Napi::Value>());
+  // descriptors can also be packed, see 'PackedDescriptors.h'
+  if (info[0].IsObject() || info[0].IsNumber()) args.push_back(info[0].As<Napi::Value>());
   Napi::Object commandEncoder = GPUCommandEncoder::constructor.New(args);
   return commandEncoder;
 }
@@ -334,6 +382,59 @@ Napi::Value GPUDevice::getQueue(const Napi::CallbackInfo& info) {
   return this->mainQueue.Value().As<Napi::Object>();
 }
 
+Napi::Value GPUDevice::getFrameStats(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  return FrameStats::GetLastFrame(env, *this->frameStats);
+}
+
+// presents all swapchains of this device, which acquired a texture since their last present
+// pending submits are flushed and the frame is ended only once for all of them
+Napi::Value GPUDevice::presentAll(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+
+  Tracer::ScopedEvent event("swapchain", "PresentAll");
+  GPUQueue* queue = Napi::ObjectWrap<GPUQueue>::Unwrap(this->mainQueue.Value());
+  queue->flushPendingSubmits();
+
+  uint32_t presented = 0;
+  for (WebGPUWindow* window : WebGPUWindow::windows) {
+    GPUSwapChain* swapChain = window->swapChain;
+    if (window->isClosed || swapChain == nullptr || !swapChain->acquired) continue;
+    if (Napi::ObjectWrap<GPUDevice>::Unwrap(swapChain->device.Value()) != this) continue;
+    swapChain->presentFrame(queue);
+    presented++;
+  };
+
+  this->uniformRing.endFrame(queue->instance);
+  FrameStats::Present(*this->frameStats);
+
+  return Napi::Number::New(env, presented);
+}
+
+Napi::Value GPUDevice::allocateUniforms(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  uint64_t size = 0;
+  if (!this->decodeUint64(info[0], size, "size")) return env.Undefined();
+  if (size == 0) {
+    this->throwCallbackError(
+      Napi::String::New(env, "Range"),
+      Napi::String::New(env, "Uniform allocations can't be empty")
+    );
+    return env.Undefined();
+  }
+  return this->uniformRing.allocate(this, info.This().As<Napi::Object>(), size);
+}
+
+Napi::Value GPUDevice::endUniformFrame(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  GPUQueue* queue = Napi::ObjectWrap<GPUQueue>::Unwrap(this->mainQueue.Value());
+  queue->flushPendingSubmits();
+  this->uniformRing.endFrame(queue->instance);
+  // headless devices end their frames here
+  FrameStats::Present(*this->frameStats);
+  return env.Undefined();
+}
+
 Napi::Object GPUDevice::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPUDevice", {
@@ -361,92 +462,140 @@ Napi::Object GPUDevice::Initialize(Napi::Env env, Napi::Object exports) {
       &GPUDevice::SetOnErrorCallback,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "getQueue",
       &GPUDevice::getQueue,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
+      "getFrameStats",
+      &GPUDevice::getFrameStats,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUDevice",
+      "presentAll",
+      &GPUDevice::presentAll,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUDevice",
+      "allocateUniforms",
+      &GPUDevice::allocateUniforms,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUDevice",
+      "endUniformFrame",
+      &GPUDevice::endUniformFrame,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUDevice",
       "tick",
       &GPUDevice::tick,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createRayTracingAccelerationContainer",
       &GPUDevice::createRayTracingAccelerationContainer,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createRayTracingShaderBindingTable",
       &GPUDevice::createRayTracingShaderBindingTable,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createRayTracingPipeline",
       &GPUDevice::createRayTracingPipeline,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createBuffer",
       &GPUDevice::createBuffer,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createBufferMapped",
       &GPUDevice::createBufferMapped,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "_createBufferMappedAsync",
       &GPUDevice::createBufferMappedAsync,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createTexture",
       &GPUDevice::createTexture,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createSampler",
       &GPUDevice::createSampler,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
+      "createQuerySet",
+      &GPUDevice::createQuerySet,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUDevice",
       "createBindGroupLayout",
       &GPUDevice::createBindGroupLayout,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createPipelineLayout",
       &GPUDevice::createPipelineLayout,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createBindGroup",
       &GPUDevice::createBindGroup,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createShaderModule",
       &GPUDevice::createShaderModule,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createComputePipeline",
       &GPUDevice::createComputePipeline,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createRenderPipeline",
       &GPUDevice::createRenderPipeline,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createCommandEncoder",
       &GPUDevice::createCommandEncoder,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUDevice",
       "createRenderBundleEncoder",
       &GPUDevice::createRenderBundleEncoder,
       napi_enumerable
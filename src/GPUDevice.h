@@ -4,6 +4,7 @@
 #include "Base.h"
 
 #include "BackendBinding.h"
+#include "UniformRing.h"
 
 class GPUDevice : public Napi::ObjectWrap<GPUDevice> {
 
@@ -23,11 +24,16 @@ class GPUDevice : public Napi::ObjectWrap<GPUDevice> {
 
     Napi::Value tick(const Napi::CallbackInfo &info);
     Napi::Value getQueue(const Napi::CallbackInfo &info);
+    Napi::Value getFrameStats(const Napi::CallbackInfo &info);
+    Napi::Value presentAll(const Napi::CallbackInfo &info);
+    Napi::Value allocateUniforms(const Napi::CallbackInfo &info);
+    Napi::Value endUniformFrame(const Napi::CallbackInfo &info);
     Napi::Value createBuffer(const Napi::CallbackInfo &info);
     Napi::Value createBufferMapped(const Napi::CallbackInfo &info);
     Napi::Value createBufferMappedAsync(const Napi::CallbackInfo &info);
     Napi::Value createTexture(const Napi::CallbackInfo &info);
     Napi::Value createSampler(const Napi::CallbackInfo &info);
+    Napi::Value createQuerySet(const Napi::CallbackInfo &info);
     Napi::Value createBindGroupLayout(const Napi::CallbackInfo &info);
     Napi::Value createPipelineLayout(const Napi::CallbackInfo &info);
     Napi::Value createBindGroup(const Napi::CallbackInfo &info);
@@ -42,18 +48,33 @@ class GPUDevice : public Napi::ObjectWrap<GPUDevice> {
 
     void throwCallbackError(const Napi::Value& type, const Napi::Value& msg);
 
+    // decodes a 64-bit offset or size, reports a RangeError if it isn't representable
+    bool decodeUint64(const Napi::Value& value, uint64_t& out, const char* name);
+
+    // flushes the deferred submits of the main queue
+    void flushPendingSubmits();
+
     Napi::ObjectReference extensions;
     Napi::ObjectReference limits;
     Napi::ObjectReference adapter;
 
     Napi::ObjectReference mainQueue;
 
+    UniformRing uniformRing;
+
+    // counters of the current and the last frame of this device
+    std::shared_ptr<FrameStats::Stats> frameStats = std::make_shared<FrameStats::Stats>();
+
     Napi::FunctionReference onErrorCallback;
 
     dawn_native::Adapter _adapter;
-    BackendBinding* binding;
+    // binding of the adapter's window, which is owned by the window
+    // headless devices own their binding
+    BackendBinding* binding = nullptr;
+    bool ownsBinding = false;
 
-    WGPUDevice instance;
+    // null if the constructor threw before creating the device
+    WGPUDevice instance = nullptr;
   private:
     Napi::Object createQueue(const Napi::CallbackInfo& info);
     BackendBinding* createBinding(const Napi::CallbackInfo& info, WGPUDevice device);
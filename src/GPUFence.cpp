@@ -15,6 +15,7 @@ GPUFence::GPUFence(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUFence>(
   this->queue.Reset(info[0].As<Napi::Object>(), 1);
   GPUQueue* queue = Napi::ObjectWrap<GPUQueue>::Unwrap(this->queue.Value());
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(queue->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPUFenceDescriptor(device, info[1].As<Napi::Value>());
 
@@ -30,13 +31,19 @@ GPUFence::~GPUFence() {
 Napi::Value GPUFence::getCompletedValue(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   uint64_t completedValue = wgpuFenceGetCompletedValue(this->instance);
-  return Napi::Number::New(env, static_cast<uint32_t>(completedValue));
+  return createUint64Value(env, completedValue);
 }
 
 Napi::Value GPUFence::onCompletion(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  uint64_t completionValue = static_cast<uint64_t>(info[0].As<Napi::Number>().Uint32Value());
+  Tracer::ScopedEvent event("fence", "OnCompletion");
+
+  GPUQueue* queue = Napi::ObjectWrap<GPUQueue>::Unwrap(this->queue.Value());
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(queue->device.Value());
+
+  uint64_t completionValue = 0;
+  if (!device->decodeUint64(info[0], completionValue, "completionValue")) return env.Undefined();
 
   Napi::Function callback = info[1].As<Napi::Function>();
 
@@ -49,13 +56,11 @@ Napi::Value GPUFence::onCompletion(const Napi::CallbackInfo &info) {
     nullptr
   );
 
-  GPUQueue* queue = Napi::ObjectWrap<GPUQueue>::Unwrap(this->queue.Value());
-  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(queue->device.Value());
   WGPUDevice backendDevice = device->instance;
 
   wgpuDeviceTick(backendDevice);
-  if (wgpuFenceGetCompletedValue(this->instance) != completionValue) {
-    while (wgpuFenceGetCompletedValue(this->instance) != completionValue) {
+  if (wgpuFenceGetCompletedValue(this->instance) < completionValue) {
+    while (wgpuFenceGetCompletedValue(this->instance) < completionValue) {
       std::this_thread::sleep_for(std::chrono::milliseconds(5));
       wgpuDeviceTick(backendDevice);
     };
@@ -69,12 +74,14 @@ Napi::Value GPUFence::onCompletion(const Napi::CallbackInfo &info) {
 Napi::Object GPUFence::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPUFence", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUFence",
       "getCompletedValue",
       &GPUFence::getCompletedValue,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUFence",
       "_onCompletion",
       &GPUFence::onCompletion,
       napi_enumerable
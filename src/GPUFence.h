@@ -21,6 +21,8 @@ class GPUFence : public Napi::ObjectWrap<GPUFence> {
     Napi::ObjectReference queue;
 
     WGPUFence instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
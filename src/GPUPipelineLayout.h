@@ -16,6 +16,8 @@ class GPUPipelineLayout : public Napi::ObjectWrap<GPUPipelineLayout> {
     Napi::ObjectReference device;
 
     WGPUPipelineLayout instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
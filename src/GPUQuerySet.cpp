@@ -0,0 +1,114 @@
+#include "GPUQuerySet.h"
+#include "GPUDevice.h"
+
+#include <chrono>
+
+Napi::FunctionReference GPUQuerySet::constructor;
+
+GPUQuerySet::GPUQuerySet(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUQuerySet>(info) {
+  Napi::Env env = info.Env();
+
+  this->device.Reset(info[0].As<Napi::Object>(), 1);
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
+
+  if (!info[1].IsObject()) {
+    device->throwCallbackError(
+      Napi::String::New(env, "Type"),
+      Napi::String::New(env, "Expected 'Object' for argument 1 in 'createQuerySet'")
+    );
+    return;
+  }
+  Napi::Object obj = info[1].As<Napi::Object>();
+
+  this->type = obj.Has("type") ? obj.Get("type").ToString().Utf8Value() : "";
+  if (this->type != "timestamp") {
+    device->throwCallbackError(
+      Napi::String::New(env, "Type"),
+      Napi::String::New(env, "Only 'timestamp' query sets are supported")
+    );
+    return;
+  }
+
+  uint64_t count = 0;
+  if (obj.Has("count") && (!getUint64Value(obj.Get("count"), count) || count > kMaxQueryCount)) {
+    device->throwCallbackError(
+      Napi::String::New(env, "Range"),
+      Napi::String::New(env, "Expected 'count' to be an integer of at most 4096 in 'createQuerySet'")
+    );
+    return;
+  }
+  this->values.resize(count, 0);
+}
+
+GPUQuerySet::~GPUQuerySet() {
+  this->device.Reset();
+}
+
+bool GPUQuerySet::writeTimestamp(uint32_t index) {
+  if (index >= this->values.size()) return false;
+  // in nanoseconds
+  this->values[index] = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+    ).count()
+  );
+  return true;
+}
+
+Napi::Value GPUQuerySet::GetType(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  return Napi::String::New(env, this->type);
+}
+
+Napi::Value GPUQuerySet::GetCount(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  return Napi::Number::New(env, static_cast<double>(this->values.size()));
+}
+
+// there are no native query sets, see 'GPUQuerySet.h'
+Napi::Value GPUQuerySet::GetEmulated(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  return Napi::Boolean::New(env, true);
+}
+
+Napi::Value GPUQuerySet::destroy(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  this->values.clear();
+  this->values.shrink_to_fit();
+  return env.Undefined();
+}
+
+Napi::Object GPUQuerySet::Initialize(Napi::Env env, Napi::Object exports) {
+  Napi::HandleScope scope(env);
+  Napi::Function func = DefineClass(env, "GPUQuerySet", {
+    InstanceAccessor(
+      "type",
+      &GPUQuerySet::GetType,
+      nullptr,
+      napi_enumerable
+    ),
+    InstanceAccessor(
+      "count",
+      &GPUQuerySet::GetCount,
+      nullptr,
+      napi_enumerable
+    ),
+    InstanceAccessor(
+      "emulated",
+      &GPUQuerySet::GetEmulated,
+      nullptr,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUQuerySet",
+      "destroy",
+      &GPUQuerySet::destroy,
+      napi_enumerable
+    )
+  });
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+  exports.Set("GPUQuerySet", func);
+  return exports;
+}
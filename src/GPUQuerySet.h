@@ -0,0 +1,51 @@
+#ifndef __GPU_QUERY_SET_H__
+#define __GPU_QUERY_SET_H__
+
+#include "Base.h"
+
+#include <vector>
+
+// query results which get written into 'buffer' once
+// the command buffer they were resolved in gets submitted
+struct GPUQueryResolve {
+  WGPUBuffer buffer;
+  uint64_t offset;
+  std::vector<uint64_t> values;
+};
+
+// the bundled dawn version has no query sets yet, timestamps
+// are taken on the CPU at the time they get encoded
+class GPUQuerySet : public Napi::ObjectWrap<GPUQuerySet> {
+
+  public:
+
+    static Napi::Object Initialize(Napi::Env env, Napi::Object exports);
+    static Napi::FunctionReference constructor;
+
+    // the spec's limit on the amount of queries in a set
+    static const uint64_t kMaxQueryCount = 4096;
+
+    GPUQuerySet(const Napi::CallbackInfo &info);
+    ~GPUQuerySet();
+
+    // #accessors
+    Napi::Value GetType(const Napi::CallbackInfo &info);
+    Napi::Value GetCount(const Napi::CallbackInfo &info);
+    Napi::Value GetEmulated(const Napi::CallbackInfo &info);
+
+    Napi::Value destroy(const Napi::CallbackInfo &info);
+
+    // returns false if the index is out of range
+    bool writeTimestamp(uint32_t index);
+
+    Napi::ObjectReference device;
+
+    std::string type;
+    std::vector<uint64_t> values;
+
+    FrameStats::Tracker frameStats;
+  private:
+
+};
+
+#endif
@@ -1,9 +1,67 @@
 #include "GPUQueue.h"
 #include "GPUDevice.h"
 #include "GPUFence.h"
+#include "GPUBuffer.h"
 #include "GPUCommandBuffer.h"
+#include "GPUTexture.h"
+
+#include "DescriptorDecoder.h"
 
 #include <vector>
+#include <cstring>
+#include <algorithm>
+
+// smallest readback size class is 4KiB
+static const uint32_t kReadbackMinSizeClassLog2 = 12;
+// amount of idle readback buffers kept alive per size class
+static const uint32_t kReadbackMaxPooledBuffers = 4;
+
+struct ReadbackRequest {
+  ReadbackRequest(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) { }
+  Napi::Promise::Deferred deferred;
+  GPUQueue* queue = nullptr;
+  WGPUBuffer buffer = nullptr;
+  uint32_t sizeClass = 0;
+  // tightly packed size of the result
+  uint64_t size = 0;
+  // texture readbacks get unpacked from the padded row pitch
+  uint64_t rowSize = 0;
+  uint64_t bytesPerRow = 0;
+  uint32_t rowCount = 0;
+};
+
+static uint32_t getReadbackSizeClass(uint64_t size) {
+  uint32_t sizeClass = 0;
+  while ((1ull << (sizeClass + kReadbackMinSizeClassLog2)) < size) sizeClass++;
+  return sizeClass;
+}
+
+static void onReadbackMapped(WGPUBufferMapAsyncStatus status, const void* data, uint64_t dataLength, void* userdata) {
+  ReadbackRequest* request = reinterpret_cast<ReadbackRequest*>(userdata);
+  Tracer::AsyncEnd("readback", "Readback", request);
+  GPUQueue* queue = request->queue;
+  Napi::Env env = request->deferred.Env();
+  if (status != WGPUBufferMapAsyncStatus_Success || data == nullptr) {
+    wgpuBufferRelease(request->buffer);
+    request->deferred.Reject(Napi::Error::New(env, "Failed to map readback buffer").Value());
+  } else {
+    Napi::ArrayBuffer out = Napi::ArrayBuffer::New(env, request->size);
+    uint8_t* dst = reinterpret_cast<uint8_t*>(out.Data());
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(data);
+    if (request->rowCount > 0 && request->rowSize != request->bytesPerRow) {
+      for (uint32_t ii = 0; ii < request->rowCount; ++ii) {
+        memcpy(dst + request->rowSize * ii, src + request->bytesPerRow * ii, request->rowSize);
+      };
+    } else {
+      memcpy(dst, src, request->size);
+    }
+    wgpuBufferUnmap(request->buffer);
+    queue->releaseReadbackBuffer(request->buffer, request->sizeClass);
+    request->deferred.Resolve(out);
+  }
+  queue->pendingReadbacks--;
+  delete request;
+}
 
 Napi::FunctionReference GPUQueue::constructor;
 
@@ -18,27 +76,165 @@ GPUQueue::GPUQueue(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUQueue>(
 
 GPUQueue::~GPUQueue() {
   this->device.Reset();
+  if (this->uploadEncoder != nullptr) wgpuCommandEncoderRelease(this->uploadEncoder);
+  for (WGPUCommandBuffer commandBuffer : this->pendingCommands) wgpuCommandBufferRelease(commandBuffer);
+  for (GPUQueryResolve& resolve : this->pendingQueryResolves) wgpuBufferRelease(resolve.buffer);
+  if (this->stagingBuffer != nullptr) wgpuBufferRelease(this->stagingBuffer);
+  for (unsigned int ii = 0; ii < kReadbackSizeClassCount; ++ii) {
+    for (WGPUBuffer buffer : this->readbackPool[ii]) wgpuBufferRelease(buffer);
+  };
   wgpuQueueRelease(this->instance);
 }
 
+WGPUBuffer GPUQueue::acquireReadbackBuffer(uint32_t sizeClass) {
+  std::vector<WGPUBuffer>& pool = this->readbackPool[sizeClass];
+  if (!pool.empty()) {
+    WGPUBuffer buffer = pool.back();
+    pool.pop_back();
+    return buffer;
+  }
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  WGPUBufferDescriptor descriptor;
+  descriptor.nextInChain = nullptr;
+  descriptor.label = nullptr;
+  descriptor.usage = static_cast<WGPUBufferUsage>(WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst);
+  descriptor.size = 1ull << (sizeClass + kReadbackMinSizeClassLog2);
+  return wgpuDeviceCreateBuffer(device->instance, &descriptor);
+}
+
+void GPUQueue::releaseReadbackBuffer(WGPUBuffer buffer, uint32_t sizeClass) {
+  std::vector<WGPUBuffer>& pool = this->readbackPool[sizeClass];
+  if (pool.size() < kReadbackMaxPooledBuffers) {
+    pool.push_back(buffer);
+  } else {
+    wgpuBufferRelease(buffer);
+  }
+}
+
+void GPUQueue::submitReadbackCopy(WGPUCommandEncoder encoder) {
+  WGPUCommandBuffer uploads = this->flushUploads();
+  if (uploads != nullptr) this->pendingCommands.push_back(uploads);
+  this->pendingCommands.push_back(wgpuCommandEncoderFinish(encoder, nullptr));
+  wgpuCommandEncoderRelease(encoder);
+  this->pendingSubmits++;
+  // the copy, and everything submitted before it, has to be executed before mapping
+  this->flushPendingSubmits();
+}
+
+uint64_t GPUQueue::allocateStagingMemory(uint64_t size) {
+  uint64_t offset = alignTo(this->stagingBufferOffset, kCopyRowPitchAlignment);
+  if (this->stagingBuffer == nullptr || offset + size > this->stagingBufferSize) {
+    GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+    // grow the staging buffer, copies which were already recorded
+    // still hold a reference to the previous buffer
+    uint64_t nextSize = std::max(this->stagingBufferSize * 2, alignTo(size, 1 << 20));
+    if (this->stagingBuffer != nullptr) wgpuBufferRelease(this->stagingBuffer);
+    WGPUBufferDescriptor descriptor;
+    descriptor.nextInChain = nullptr;
+    descriptor.label = nullptr;
+    descriptor.usage = static_cast<WGPUBufferUsage>(WGPUBufferUsage_CopySrc | WGPUBufferUsage_CopyDst);
+    descriptor.size = nextSize;
+    this->stagingBuffer = wgpuDeviceCreateBuffer(device->instance, &descriptor);
+    this->stagingBufferSize = nextSize;
+    offset = 0;
+  }
+  this->stagingBufferOffset = offset + size;
+  return offset;
+}
+
+WGPUCommandBuffer GPUQueue::flushUploads() {
+  if (this->uploadEncoder == nullptr) return nullptr;
+  WGPUCommandBuffer commandBuffer = wgpuCommandEncoderFinish(this->uploadEncoder, nullptr);
+  wgpuCommandEncoderRelease(this->uploadEncoder);
+  this->uploadEncoder = nullptr;
+  return commandBuffer;
+}
+
+void GPUQueue::flushPendingSubmits() {
+  // texture uploads are pending too, even without a deferred submit
+  if (this->pendingSubmits == 0 && this->uploadEncoder == nullptr) return;
+
+  // uploads recorded after the last deferred submit
+  WGPUCommandBuffer uploads = this->flushUploads();
+  if (uploads != nullptr) this->pendingCommands.push_back(uploads);
+
+  // resolved queries are written ahead of the submission
+  for (GPUQueryResolve& resolve : this->pendingQueryResolves) {
+    wgpuBufferSetSubData(
+      resolve.buffer,
+      resolve.offset,
+      resolve.values.size() * sizeof(uint64_t),
+      reinterpret_cast<const uint8_t*>(resolve.values.data())
+    );
+    wgpuBufferRelease(resolve.buffer);
+  };
+  this->pendingQueryResolves.clear();
+
+  // uniform slices written since the last submit
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  device->uniformRing.flush();
+
+  FrameStats::Counters& counters = device->frameStats->counters;
+  wgpuQueueSubmit(this->instance, static_cast<uint32_t>(this->pendingCommands.size()), this->pendingCommands.data());
+  FrameStats::Increment(counters.commandBuffersSubmitted, this->pendingCommands.size());
+  FrameStats::Increment(counters.queueSubmits);
+  if (this->pendingSubmits > 1) {
+    FrameStats::Increment(counters.submitsCoalesced, this->pendingSubmits - 1);
+  }
+
+  for (WGPUCommandBuffer commandBuffer : this->pendingCommands) wgpuCommandBufferRelease(commandBuffer);
+  // keeps the capacity, so the next submits don't allocate again
+  this->pendingCommands.clear();
+  this->pendingSubmits = 0;
+
+  // staging writes are queue-ordered, so the memory can be reused right after the submit
+  this->stagingBufferOffset = 0;
+}
+
 Napi::Value GPUQueue::submit(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
+  Tracer::ScopedEvent event("queue", "Submit");
+
   Napi::Array array = info[0].As<Napi::Array>();
 
   uint32_t length = array.Length();
-  std::vector<WGPUCommandBuffer> commands;
+
+  // pending uploads have to be executed before any user commands
+  WGPUCommandBuffer uploads = this->flushUploads();
+  if (uploads != nullptr) this->pendingCommands.push_back(uploads);
+
   for (unsigned int ii = 0; ii < length; ++ii) {
     Napi::Object item = array.Get(ii).As<Napi::Object>();
-    WGPUCommandBuffer value = Napi::ObjectWrap<GPUCommandBuffer>::Unwrap(item)->instance;
-    commands.push_back(value);
+    GPUCommandBuffer* commandBuffer = Napi::ObjectWrap<GPUCommandBuffer>::Unwrap(item);
+    // the command buffer can get collected before the pending list is flushed
+    wgpuCommandBufferReference(commandBuffer->instance);
+    this->pendingCommands.push_back(commandBuffer->instance);
+    for (GPUQueryResolve& resolve : commandBuffer->queryResolves) {
+      this->pendingQueryResolves.push_back(std::move(resolve));
+    };
+    commandBuffer->queryResolves.clear();
   };
+  this->pendingSubmits++;
 
-  wgpuQueueSubmit(this->instance, length, commands.data());
+  if (!this->deferSubmits) this->flushPendingSubmits();
 
   return env.Undefined();
 }
 
+Napi::Value GPUQueue::setDeferredSubmit(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  this->deferSubmits = info[0].IsBoolean() ? info[0].As<Napi::Boolean>().Value() : true;
+  if (!this->deferSubmits) this->flushPendingSubmits();
+  return env.Undefined();
+}
+
+Napi::Value GPUQueue::flush(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  this->flushPendingSubmits();
+  return env.Undefined();
+}
+
 Napi::Value GPUQueue::createFence(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   std::vector<napi_value> args = {
@@ -56,29 +252,328 @@ Napi::Value GPUQueue::signal(const Napi::CallbackInfo &info) {
 
   WGPUFence fence = Napi::ObjectWrap<GPUFence>::Unwrap(info[0].ToObject())->instance;
 
-  uint64_t signalValue = static_cast<uint64_t>(info[0].As<Napi::Number>().Uint32Value());
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+
+  uint64_t signalValue = 0;
+  if (!device->decodeUint64(info[1], signalValue, "signalValue")) return env.Undefined();
+  // the fence has to signal after all deferred submits
+  this->flushPendingSubmits();
   wgpuQueueSignal(this->instance, fence, signalValue);
 
   return env.Undefined();
 }
 
+Napi::Value GPUQueue::writeTexture(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+
+  if (!info[0].IsObject() || !info[2].IsObject() || !info[3].IsObject()) {
+    Napi::String type = Napi::String::New(env, "Type");
+    Napi::String message = Napi::String::New(env, "Invalid Function Signature for 'GPUQueue::writeTexture'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+
+  Napi::Value textureValue = info[0].As<Napi::Object>().Get("texture");
+  if (!textureValue.IsObject() || !textureValue.As<Napi::Object>().InstanceOf(GPUTexture::constructor.Value())) {
+    Napi::String type = Napi::String::New(env, "Type");
+    Napi::String message = Napi::String::New(env, "Expected 'GPUTexture' for 'destination.texture' in 'GPUQueue::writeTexture'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+  GPUTexture* texture = Napi::ObjectWrap<GPUTexture>::Unwrap(textureValue.As<Napi::Object>());
+
+  auto destination = DescriptorDecoder::GPUTextureCopyView(device, info[0].As<Napi::Value>());
+  WGPUExtent3D copySize = DescriptorDecoder::DecodeGPUExtent3D(device, info[3].As<Napi::Value>());
+
+  size_t dataLength = 0;
+  uint8_t* data = getTypedArrayData<uint8_t>(info[1].As<Napi::Value>(), &dataLength);
+  if (data == nullptr) return env.Undefined();
+
+  // source data layout
+  Napi::Object layout = info[2].As<Napi::Object>();
+  uint64_t dataOffset = 0;
+  if (layout.Has("offset") && !device->decodeUint64(layout.Get("offset"), dataOffset, "dataLayout.offset")) {
+    return env.Undefined();
+  }
+
+  uint32_t blockSize = GPUTexture::GetFormatBlockSize(texture->format);
+  uint32_t blockDimension = GPUTexture::GetFormatBlockDimension(texture->format);
+  uint32_t widthInBlocks = (copySize.width + blockDimension - 1) / blockDimension;
+  uint32_t heightInBlocks = (copySize.height + blockDimension - 1) / blockDimension;
+
+  uint64_t rowSize = static_cast<uint64_t>(widthInBlocks) * blockSize;
+  uint64_t srcBytesPerRow = rowSize;
+  if (layout.Has("bytesPerRow")) srcBytesPerRow = layout.Get("bytesPerRow").As<Napi::Number>().Uint32Value();
+  uint32_t srcRowsPerImage = heightInBlocks;
+  if (layout.Has("rowsPerImage") && layout.Get("rowsPerImage").As<Napi::Number>().Uint32Value() > 0) {
+    srcRowsPerImage = layout.Get("rowsPerImage").As<Napi::Number>().Uint32Value() / blockDimension;
+  }
+
+  if (blockSize == 0 || srcBytesPerRow < rowSize || srcRowsPerImage < heightInBlocks) {
+    Napi::String type = Napi::String::New(env, "Range");
+    Napi::String message = Napi::String::New(env, "Invalid data layout for 'GPUQueue::writeTexture'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+
+  // empty copies are valid, but there is nothing to upload
+  if (widthInBlocks == 0 || heightInBlocks == 0) {
+    if (dataOffset > dataLength) {
+      Napi::String type = Napi::String::New(env, "Range");
+      Napi::String message = Napi::String::New(env, "Data is too small for the specified copy in 'GPUQueue::writeTexture'");
+      device->throwCallbackError(type, message);
+    }
+    return env.Undefined();
+  }
+
+  uint32_t depth = std::max(copySize.depth, 1u);
+  uint64_t requiredLength = (
+    dataOffset +
+    srcBytesPerRow * srcRowsPerImage * (depth - 1) +
+    srcBytesPerRow * (heightInBlocks - 1) +
+    rowSize
+  );
+  if (requiredLength > dataLength) {
+    Napi::String type = Napi::String::New(env, "Range");
+    Napi::String message = Napi::String::New(env, "Data is too small for the specified copy in 'GPUQueue::writeTexture'");
+    device->throwCallbackError(type, message);
+    return env.Undefined();
+  }
+
+  uint64_t dstBytesPerRow = alignTo(rowSize, kCopyRowPitchAlignment);
+  uint64_t dstImageSize = dstBytesPerRow * heightInBlocks;
+  uint64_t stagingSize = dstImageSize * depth;
+
+  uint8_t* src = data + dataOffset;
+  const uint8_t* upload = src;
+  // repack rows into the required row pitch, if the source layout is already
+  // tightly packed in the destination layout, the data can be uploaded directly
+  // rows are copied with memcpy, which libc already implements with simd
+  // for each target, a hand-written simd copy wouldn't be faster for whole rows
+  if (srcBytesPerRow != dstBytesPerRow || (depth > 1 && srcRowsPerImage != heightInBlocks)) {
+    this->uploadScratch.resize(stagingSize);
+    uint8_t* dst = this->uploadScratch.data();
+    for (uint32_t zz = 0; zz < depth; ++zz) {
+      const uint8_t* srcImage = src + srcBytesPerRow * srcRowsPerImage * zz;
+      uint8_t* dstImage = dst + dstImageSize * zz;
+      for (uint32_t yy = 0; yy < heightInBlocks; ++yy) {
+        memcpy(dstImage + dstBytesPerRow * yy, srcImage + srcBytesPerRow * yy, rowSize);
+      };
+    };
+    upload = dst;
+  }
+  // the last row of the source is not padded
+  else if (dataLength - dataOffset < stagingSize) {
+    this->uploadScratch.resize(stagingSize);
+    memcpy(this->uploadScratch.data(), src, dataLength - dataOffset);
+    upload = this->uploadScratch.data();
+  }
+
+  uint64_t stagingOffset = this->allocateStagingMemory(stagingSize);
+  wgpuBufferSetSubData(this->stagingBuffer, stagingOffset, stagingSize, upload);
+  FrameStats::Increment(device->frameStats->counters.bufferBytesUploaded, stagingSize);
+
+  if (this->uploadEncoder == nullptr) {
+    this->uploadEncoder = wgpuDeviceCreateCommandEncoder(device->instance, nullptr);
+  }
+
+  WGPUBufferCopyView source;
+  source.nextInChain = nullptr;
+  source.buffer = this->stagingBuffer;
+  source.offset = stagingOffset;
+  source.bytesPerRow = static_cast<uint32_t>(dstBytesPerRow);
+  source.rowsPerImage = heightInBlocks * blockDimension;
+
+  wgpuCommandEncoderCopyBufferToTexture(this->uploadEncoder, &source, &destination, &copySize);
+
+  return env.Undefined();
+}
+
+Napi::Value GPUQueue::readBuffer(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+
+  if (!info[0].IsObject() || !info[0].As<Napi::Object>().InstanceOf(GPUBuffer::constructor.Value())) {
+    deferred.Reject(Napi::TypeError::New(env, "Expected 'GPUBuffer' for argument 1 in 'readBuffer'").Value());
+    return deferred.Promise();
+  }
+  GPUBuffer* source = Napi::ObjectWrap<GPUBuffer>::Unwrap(info[0].As<Napi::Object>());
+
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  if (
+    (!info[1].IsUndefined() && !getUint64Value(info[1], offset)) ||
+    (!info[2].IsUndefined() && !getUint64Value(info[2], size))
+  ) {
+    deferred.Reject(Napi::RangeError::New(env, "Readback offset and size must be a non-negative safe integer or a BigInt below 2^64").Value());
+    return deferred.Promise();
+  }
+  if (size == 0 || (offset % 4) != 0 || (size % 4) != 0) {
+    deferred.Reject(Napi::RangeError::New(env, "Readback offset and size must be a non-zero multiple of 4").Value());
+    return deferred.Promise();
+  }
+
+  uint32_t sizeClass = getReadbackSizeClass(size);
+  if (sizeClass >= kReadbackSizeClassCount) {
+    deferred.Reject(Napi::RangeError::New(env, "Readback size is too large").Value());
+    return deferred.Promise();
+  }
+
+  ReadbackRequest* request = new ReadbackRequest(env);
+  request->queue = this;
+  request->buffer = this->acquireReadbackBuffer(sizeClass);
+  request->sizeClass = sizeClass;
+  request->size = size;
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device->instance, nullptr);
+  wgpuCommandEncoderCopyBufferToBuffer(encoder, source->instance, offset, request->buffer, 0, size);
+  this->submitReadbackCopy(encoder);
+
+  this->pendingReadbacks++;
+  Tracer::AsyncBegin("readback", "Readback", request);
+  wgpuBufferMapReadAsync(request->buffer, onReadbackMapped, request);
+
+  return request->deferred.Promise();
+}
+
+Napi::Value GPUQueue::readTexture(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+
+  if (!info[0].IsObject() || !info[1].IsObject()) {
+    deferred.Reject(Napi::TypeError::New(env, "Invalid Function Signature for 'readTexture'").Value());
+    return deferred.Promise();
+  }
+
+  Napi::Value textureValue = info[0].As<Napi::Object>().Get("texture");
+  if (!textureValue.IsObject() || !textureValue.As<Napi::Object>().InstanceOf(GPUTexture::constructor.Value())) {
+    deferred.Reject(Napi::TypeError::New(env, "Expected 'GPUTexture' for 'source.texture' in 'readTexture'").Value());
+    return deferred.Promise();
+  }
+  GPUTexture* texture = Napi::ObjectWrap<GPUTexture>::Unwrap(textureValue.As<Napi::Object>());
+
+  auto source = DescriptorDecoder::GPUTextureCopyView(device, info[0].As<Napi::Value>());
+  WGPUExtent3D copySize = DescriptorDecoder::DecodeGPUExtent3D(device, info[1].As<Napi::Value>());
+
+  uint32_t blockSize = GPUTexture::GetFormatBlockSize(texture->format);
+  uint32_t blockDimension = GPUTexture::GetFormatBlockDimension(texture->format);
+  uint32_t widthInBlocks = (copySize.width + blockDimension - 1) / blockDimension;
+  uint32_t heightInBlocks = (copySize.height + blockDimension - 1) / blockDimension;
+  uint32_t depth = std::max(copySize.depth, 1u);
+
+  uint64_t rowSize = static_cast<uint64_t>(widthInBlocks) * blockSize;
+  uint64_t bytesPerRow = alignTo(rowSize, kCopyRowPitchAlignment);
+  uint32_t rowCount = heightInBlocks * depth;
+  if (blockSize == 0 || rowCount == 0 || rowSize == 0) {
+    deferred.Reject(Napi::RangeError::New(env, "Invalid texture readback").Value());
+    return deferred.Promise();
+  }
+
+  uint32_t sizeClass = getReadbackSizeClass(bytesPerRow * rowCount);
+  if (sizeClass >= kReadbackSizeClassCount) {
+    deferred.Reject(Napi::RangeError::New(env, "Readback size is too large").Value());
+    return deferred.Promise();
+  }
+
+  ReadbackRequest* request = new ReadbackRequest(env);
+  request->queue = this;
+  request->buffer = this->acquireReadbackBuffer(sizeClass);
+  request->sizeClass = sizeClass;
+  request->size = rowSize * rowCount;
+  request->rowSize = rowSize;
+  request->bytesPerRow = bytesPerRow;
+  request->rowCount = rowCount;
+
+  WGPUBufferCopyView destination;
+  destination.nextInChain = nullptr;
+  destination.buffer = request->buffer;
+  destination.offset = 0;
+  destination.bytesPerRow = static_cast<uint32_t>(bytesPerRow);
+  destination.rowsPerImage = heightInBlocks * blockDimension;
+
+  WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device->instance, nullptr);
+  wgpuCommandEncoderCopyTextureToBuffer(encoder, &source, &destination, &copySize);
+  this->submitReadbackCopy(encoder);
+
+  this->pendingReadbacks++;
+  Tracer::AsyncBegin("readback", "Readback", request);
+  wgpuBufferMapReadAsync(request->buffer, onReadbackMapped, request);
+
+  return request->deferred.Promise();
+}
+
+Napi::Value GPUQueue::tickReadbacks(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (this->pendingReadbacks > 0) {
+    GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+    wgpuDeviceTick(device->instance);
+  }
+  return Napi::Number::New(env, this->pendingReadbacks);
+}
+
 Napi::Object GPUQueue::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPUQueue", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUQueue",
       "submit",
       &GPUQueue::submit,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUQueue",
       "createFence",
       &GPUQueue::createFence,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUQueue",
       "signal",
       &GPUQueue::signal,
       napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUQueue",
+      "writeTexture",
+      &GPUQueue::writeTexture,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUQueue",
+      "_readBuffer",
+      &GPUQueue::readBuffer,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUQueue",
+      "_readTexture",
+      &GPUQueue::readTexture,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUQueue",
+      "_tickReadbacks",
+      &GPUQueue::tickReadbacks,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUQueue",
+      "setDeferredSubmit",
+      &GPUQueue::setDeferredSubmit,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUQueue",
+      "flush",
+      &GPUQueue::flush,
+      napi_enumerable
     )
   });
   constructor = Napi::Persistent(func);
@@ -2,6 +2,9 @@
 #define __GPU_QUEUE_H__
 
 #include "Base.h"
+#include "GPUQuerySet.h"
+
+#include <vector>
 
 class GPUQueue : public Napi::ObjectWrap<GPUQueue> {
 
@@ -16,11 +19,52 @@ class GPUQueue : public Napi::ObjectWrap<GPUQueue> {
     Napi::Value submit(const Napi::CallbackInfo &info);
     Napi::Value createFence(const Napi::CallbackInfo &info);
     Napi::Value signal(const Napi::CallbackInfo &info);
+    Napi::Value writeTexture(const Napi::CallbackInfo &info);
+    Napi::Value readBuffer(const Napi::CallbackInfo &info);
+    Napi::Value readTexture(const Napi::CallbackInfo &info);
+    Napi::Value tickReadbacks(const Napi::CallbackInfo &info);
+    Napi::Value setDeferredSubmit(const Napi::CallbackInfo &info);
+    Napi::Value flush(const Napi::CallbackInfo &info);
+
+    // submits the command buffers of all pending submits at once
+    void flushPendingSubmits();
+
+    WGPUBuffer acquireReadbackBuffer(uint32_t sizeClass);
+    void releaseReadbackBuffer(WGPUBuffer buffer, uint32_t sizeClass);
+
+    uint32_t pendingReadbacks = 0;
 
     Napi::ObjectReference device;
 
     WGPUQueue instance;
   private:
+    // staging memory shared by all uploads of this queue,
+    // it gets suballocated linearly and is reset on each submit
+    WGPUBuffer stagingBuffer = nullptr;
+    uint64_t stagingBufferSize = 0;
+    uint64_t stagingBufferOffset = 0;
+
+    // upload copies are recorded into this encoder and get
+    // submitted in front of the command buffers of the next submit
+    WGPUCommandEncoder uploadEncoder = nullptr;
+
+    // in deferred mode, submits only get appended to the pending list, which gets
+    // flushed as a single submit at present, signal, mapping or an explicit flush
+    bool deferSubmits = false;
+    uint32_t pendingSubmits = 0;
+    std::vector<WGPUCommandBuffer> pendingCommands;
+    std::vector<GPUQueryResolve> pendingQueryResolves;
+
+    // scratch memory used to repack rows to the required row pitch
+    std::vector<uint8_t> uploadScratch;
+
+    // MAP_READ buffers reused across readbacks, bucketed by power-of-two size classes
+    static const uint32_t kReadbackSizeClassCount = 32;
+    std::vector<WGPUBuffer> readbackPool[kReadbackSizeClassCount];
+
+    uint64_t allocateStagingMemory(uint64_t size);
+    void submitReadbackCopy(WGPUCommandEncoder encoder);
+    WGPUCommandBuffer flushUploads();
 
 };
 
@@ -14,6 +14,7 @@ GPURayTracingAccelerationContainer::GPURayTracingAccelerationContainer(const Nap
 
   this->device.Reset(info[0].As<Napi::Object>(), 1);
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPURayTracingAccelerationContainerDescriptor(device, info[1].As<Napi::Value>());
   this->instance = wgpuDeviceCreateRayTracingAccelerationContainer(device->instance, &descriptor);
@@ -44,12 +45,14 @@ Napi::Value GPURayTracingAccelerationContainer::updateInstance(const Napi::Callb
 Napi::Object GPURayTracingAccelerationContainer::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPURayTracingAccelerationContainer", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPURayTracingAccelerationContainer",
       "destroy",
       &GPURayTracingAccelerationContainer::destroy,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPURayTracingAccelerationContainer",
       "updateInstance",
       &GPURayTracingAccelerationContainer::updateInstance,
       napi_enumerable
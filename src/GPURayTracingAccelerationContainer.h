@@ -20,6 +20,8 @@ class GPURayTracingAccelerationContainer : public Napi::ObjectWrap<GPURayTracing
 
     WGPURayTracingAccelerationContainer instance;
 
+    FrameStats::Tracker frameStats;
+
   private:
 
 };
@@ -2,8 +2,9 @@
 #define __GPU_RAY_TRACING_PASS_ENCODER_H__
 
 #include "Base.h"
+#include "PassEncoderBase.h"
 
-class GPURayTracingPassEncoder : public Napi::ObjectWrap<GPURayTracingPassEncoder> {
+class GPURayTracingPassEncoder : public PassEncoderBase<GPURayTracingPassEncoder, GPURayTracingPassEncoderProcs> {
 
   public:
 
@@ -13,25 +14,6 @@ class GPURayTracingPassEncoder : public Napi::ObjectWrap<GPURayTracingPassEncode
     GPURayTracingPassEncoder(const Napi::CallbackInfo &info);
     ~GPURayTracingPassEncoder();
 
-    // GPURenderEncoderBase BEGIN
-    Napi::Value setPipeline(const Napi::CallbackInfo &info);
-    Napi::Value traceRays(const Napi::CallbackInfo &info);
-    Napi::Value endPass(const Napi::CallbackInfo &info);
-    // GPURenderEncoderBase END
-
-    // GPUProgrammablePassEncoder BEGIN
-    Napi::Value setBindGroup(const Napi::CallbackInfo &info);
-    Napi::Value pushDebugGroup(const Napi::CallbackInfo &info);
-    Napi::Value popDebugGroup(const Napi::CallbackInfo &info);
-    Napi::Value insertDebugMarker(const Napi::CallbackInfo &info);
-    // GPUProgrammablePassEncoder END
-
-    Napi::ObjectReference device;
-    Napi::ObjectReference commandEncoder;
-
-    WGPURayTracingPassEncoder instance;
-  private:
-
 };
 
 #endif
@@ -11,6 +11,7 @@ GPURayTracingPipeline::GPURayTracingPipeline(const Napi::CallbackInfo& info) : N
 
   this->device.Reset(info[0].As<Napi::Object>(), 1);
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPURayTracingPipelineDescriptor(device, info[1].As<Napi::Value>());
 
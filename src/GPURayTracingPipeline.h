@@ -16,6 +16,8 @@ class GPURayTracingPipeline : public Napi::ObjectWrap<GPURayTracingPipeline> {
     Napi::ObjectReference device;
 
     WGPURayTracingPipeline instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
@@ -14,6 +14,7 @@ GPURayTracingShaderBindingTable::GPURayTracingShaderBindingTable(const Napi::Cal
 
   this->device.Reset(info[0].As<Napi::Object>(), 1);
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPURayTracingShaderBindingTableDescriptor(device, info[1].As<Napi::Value>());
   this->instance = wgpuDeviceCreateRayTracingShaderBindingTable(device->instance, &descriptor);
@@ -33,7 +34,8 @@ Napi::Value GPURayTracingShaderBindingTable::destroy(const Napi::CallbackInfo &i
 Napi::Object GPURayTracingShaderBindingTable::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPURayTracingShaderBindingTable", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPURayTracingShaderBindingTable",
       "destroy",
       &GPURayTracingShaderBindingTable::destroy,
       napi_enumerable
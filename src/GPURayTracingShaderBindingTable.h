@@ -19,6 +19,8 @@ class GPURayTracingShaderBindingTable : public Napi::ObjectWrap<GPURayTracingSha
 
     WGPURayTracingShaderBindingTable instance;
 
+    FrameStats::Tracker frameStats;
+
   private:
 
 };
@@ -14,6 +14,8 @@ class GPURenderBundle : public Napi::ObjectWrap<GPURenderBundle> {
     ~GPURenderBundle();
 
     WGPURenderBundle instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
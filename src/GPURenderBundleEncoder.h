@@ -2,8 +2,9 @@
 #define __GPU_RENDER_BUNDLE_ENCODER_H__
 
 #include "Base.h"
+#include "PassEncoderBase.h"
 
-class GPURenderBundleEncoder : public Napi::ObjectWrap<GPURenderBundleEncoder> {
+class GPURenderBundleEncoder : public PassEncoderBase<GPURenderBundleEncoder, GPURenderBundleEncoderProcs> {
 
   public:
 
@@ -13,33 +14,10 @@ class GPURenderBundleEncoder : public Napi::ObjectWrap<GPURenderBundleEncoder> {
     GPURenderBundleEncoder(const Napi::CallbackInfo &info);
     ~GPURenderBundleEncoder();
 
-    // GPURenderEncoderBase BEGIN
-    Napi::Value setPipeline(const Napi::CallbackInfo &info);
-    Napi::Value setIndexBuffer(const Napi::CallbackInfo &info);
-    Napi::Value setVertexBuffer(const Napi::CallbackInfo &info);
-    Napi::Value draw(const Napi::CallbackInfo &info);
-    Napi::Value drawIndexed(const Napi::CallbackInfo &info);
-    Napi::Value drawIndirect(const Napi::CallbackInfo &info);
-    Napi::Value drawIndexedIndirect(const Napi::CallbackInfo &info);
-    // GPURenderEncoderBase END
-
     // GPURenderBundleEncoder BEGIN
     Napi::Value finish(const Napi::CallbackInfo &info);
     // GPURenderBundleEncoder END
 
-    // GPUProgrammablePassEncoder BEGIN
-    Napi::Value setBindGroup(const Napi::CallbackInfo &info);
-    Napi::Value pushDebugGroup(const Napi::CallbackInfo &info);
-    Napi::Value popDebugGroup(const Napi::CallbackInfo &info);
-    Napi::Value insertDebugMarker(const Napi::CallbackInfo &info);
-    // GPUProgrammablePassEncoder END
-
-    Napi::ObjectReference device;
-    Napi::ObjectReference commandEncoder;
-
-    WGPURenderBundleEncoder instance;
-  private:
-
 };
 
 #endif
@@ -16,6 +16,8 @@ class GPURenderPipeline : public Napi::ObjectWrap<GPURenderPipeline> {
     Napi::ObjectReference device;
 
     WGPURenderPipeline instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
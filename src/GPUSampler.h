@@ -16,6 +16,8 @@ class GPUSampler : public Napi::ObjectWrap<GPUSampler> {
     Napi::ObjectReference device;
 
     WGPUSampler instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
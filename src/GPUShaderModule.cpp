@@ -10,8 +10,11 @@ Napi::FunctionReference GPUShaderModule::constructor;
 GPUShaderModule::GPUShaderModule(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUShaderModule>(info) {
   Napi::Env env = info.Env();
 
+  Tracer::ScopedEvent event("shader", "CompileShaderModule");
+
   this->device.Reset(info[0].As<Napi::Object>(), 1);
   GPUDevice* uwDevice = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(uwDevice->frameStats);
   WGPUDevice backendDevice = uwDevice->instance;
 
   WGPUShaderModuleSPIRVDescriptor spirvDescriptor;
@@ -27,32 +30,18 @@ GPUShaderModule::GPUShaderModule(const Napi::CallbackInfo& info) : Napi::ObjectW
     Napi::Value code = obj.Get("code");
     // code is 'String'
     if (code.IsString()) {
-      // shaderc inputs
-      const char* source = getNAPIStringCopy(code);
-      size_t size = strlen(source);
-      shaderc_shader_kind kind = shaderc_glsl_infer_from_source;
-
-      shaderc::Compiler compiler;
-
-      auto result = compiler.CompileGlslToSpv(source, size, kind, "shader");
-
-      if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+      std::vector<uint32_t> spirv;
+      std::string error;
+      if (!CompileGLSL(code.As<Napi::String>().Utf8Value(), spirv, error)) {
         uwDevice->throwCallbackError(
           Napi::String::New(env, "Error"),
-          Napi::String::New(env, result.GetErrorMessage())
+          Napi::String::New(env, error)
         );
         return;
       }
-
-      const uint32_t* resultBegin = result.cbegin();
-      const uint32_t* resultEnd = result.cend();
-
-      ptrdiff_t resultSize = resultEnd - resultBegin;
-
-      spirvDescriptor.code = result.cbegin();
-      spirvDescriptor.codeSize = static_cast<uint32_t>(resultSize);
+      spirvDescriptor.code = spirv.data();
+      spirvDescriptor.codeSize = static_cast<uint32_t>(spirv.size());
       this->instance = wgpuDeviceCreateShaderModule(backendDevice, &descriptor);
-      delete source;
     }
     // code is 'Uint32Array'
     else if (code.IsTypedArray()) {
@@ -79,6 +68,20 @@ GPUShaderModule::GPUShaderModule(const Napi::CallbackInfo& info) : Napi::ObjectW
 
 }
 
+bool GPUShaderModule::CompileGLSL(const std::string& source, std::vector<uint32_t>& spirv, std::string& error) {
+  shaderc::Compiler compiler;
+
+  auto result = compiler.CompileGlslToSpv(source.c_str(), source.size(), shaderc_glsl_infer_from_source, "shader");
+
+  if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
+    error = result.GetErrorMessage();
+    return false;
+  }
+
+  spirv.assign(result.cbegin(), result.cend());
+  return true;
+}
+
 GPUShaderModule::~GPUShaderModule() {
   this->device.Reset();
   wgpuShaderModuleRelease(this->instance);
@@ -3,6 +3,9 @@
 
 #include "Base.h"
 
+#include <string>
+#include <vector>
+
 class GPUShaderModule : public Napi::ObjectWrap<GPUShaderModule> {
 
   public:
@@ -13,9 +16,14 @@ class GPUShaderModule : public Napi::ObjectWrap<GPUShaderModule> {
     GPUShaderModule(const Napi::CallbackInfo &info);
     ~GPUShaderModule();
 
+    // compiles GLSL into SPIR-V, returns false and the error message on failure
+    static bool CompileGLSL(const std::string& source, std::vector<uint32_t>& spirv, std::string& error);
+
     Napi::ObjectReference device;
 
     WGPUShaderModule instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
@@ -1,5 +1,6 @@
 #include "GPUSwapChain.h"
 #include "GPUDevice.h"
+#include "GPUQueue.h"
 #include "GPUTexture.h"
 #include "BackendBinding.h"
 #include "GPUCanvasContext.h"
@@ -7,6 +8,9 @@
 
 #include "DescriptorDecoder.h"
 
+#include <cmath>
+#include <algorithm>
+
 Napi::FunctionReference GPUSwapChain::constructor;
 
 GPUSwapChain::GPUSwapChain(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUSwapChain>(info) {
@@ -20,11 +24,12 @@ GPUSwapChain::GPUSwapChain(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GP
 
   this->device.Reset(args.Get("device").As<Napi::Object>(), 1);
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   // create
   WGPUSwapChainDescriptor descriptor;
   descriptor.nextInChain = nullptr;
-  descriptor.implementation = device->binding->GetSwapChainImplementation();
+  descriptor.implementation = window->getBinding(device)->GetSwapChainImplementation();
 
   this->instance = wgpuDeviceCreateSwapChain(device->instance, nullptr, &descriptor);
 
@@ -44,11 +49,17 @@ GPUSwapChain::GPUSwapChain(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GP
   this->usage = usage;
 
   window->swapChain = this;
+  this->window = window;
 }
 
 GPUSwapChain::~GPUSwapChain() {
   this->device.Reset();
   this->context.Reset();
+  // the window can be gone already
+  auto it = std::find(WebGPUWindow::windows.begin(), WebGPUWindow::windows.end(), this->window);
+  if (it != WebGPUWindow::windows.end() && this->window->swapChain == this) this->window->swapChain = nullptr;
+  if (this->frameWait != nullptr) this->frameWait->swapChain = nullptr;
+  if (this->frameFence != nullptr) wgpuFenceRelease(this->frameFence);
   wgpuSwapChainRelease(this->instance);
 }
 
@@ -56,6 +67,7 @@ Napi::Value GPUSwapChain::getCurrentTextureView(const Napi::CallbackInfo &info)
   Napi::Env env = info.Env();
 
   WGPUTextureView nextTextureView = wgpuSwapChainGetCurrentTextureView(this->instance);
+  this->acquired = true;
 
   std::vector<napi_value> args = {
     info.This().As<Napi::Value>(),
@@ -65,6 +77,8 @@ Napi::Value GPUSwapChain::getCurrentTextureView(const Napi::CallbackInfo &info)
   Napi::Object textureView = GPUTextureView::constructor.New(args);
 
   GPUTextureView* uwTexture = Napi::ObjectWrap<GPUTextureView>::Unwrap(textureView);
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  uwTexture->frameStats.track(device->frameStats);
   uwTexture->instance = nextTextureView;
 
   return textureView;
@@ -73,23 +87,200 @@ Napi::Value GPUSwapChain::getCurrentTextureView(const Napi::CallbackInfo &info)
 Napi::Value GPUSwapChain::present(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
+  Tracer::ScopedEvent event("swapchain", "Present");
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  GPUQueue* queue = Napi::ObjectWrap<GPUQueue>::Unwrap(device->mainQueue.Value());
+  queue->flushPendingSubmits();
+
+  this->presentFrame(queue);
+
+  device->uniformRing.endFrame(queue->instance);
+  FrameStats::Present(*device->frameStats);
+
+  return env.Undefined();
+}
+
+void GPUSwapChain::presentFrame(GPUQueue* queue) {
   wgpuSwapChainPresent(this->instance);
+  this->acquired = false;
+
+  if (this->frameFence == nullptr) {
+    WGPUFenceDescriptor descriptor;
+    descriptor.nextInChain = nullptr;
+    descriptor.label = nullptr;
+    descriptor.initialValue = 0;
+    this->frameFence = wgpuQueueCreateFence(queue->instance, &descriptor);
+  }
+  wgpuQueueSignal(queue->instance, this->frameFence, ++this->framesPresented);
+
+  uint64_t now = Profiler::Now();
+  if (this->lastPresentTime != 0) {
+    uint64_t frameTime = now - this->lastPresentTime;
+    if (this->frameTimes.size() < kFrameTimeHistorySize) {
+      this->frameTimes.push_back(frameTime);
+    } else {
+      this->frameTimes[this->frameTimeIndex] = frameTime;
+    }
+    this->frameTimeIndex = (this->frameTimeIndex + 1) % kFrameTimeHistorySize;
+  }
+  this->lastPresentTime = now;
+}
+
+// returns 0 if the next frame can be started, the time in ms until it can
+// be started when ahead of the target rate, or -1 while too many frames are in flight
+Napi::Value GPUSwapChain::tickFrame(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (this->frameFence != nullptr) {
+    GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+    wgpuDeviceTick(device->instance);
+    uint64_t framesInFlight = this->framesPresented - wgpuFenceGetCompletedValue(this->frameFence);
+    if (framesInFlight >= this->maxFramesInFlight) return Napi::Number::New(env, -1);
+  }
+
+  uint64_t now = Profiler::Now();
+  if (this->targetFrameRate > 0.0) {
+    uint64_t interval = static_cast<uint64_t>(1e9 / this->targetFrameRate);
+    uint64_t nextFrameTime = this->lastFrameTime + interval;
+    if (now < nextFrameTime) return Napi::Number::New(env, (nextFrameTime - now) * 1e-6);
+    // stay on the frame grid, unless we fell behind by more than a frame
+    this->lastFrameTime = now - nextFrameTime > interval ? now : nextFrameTime;
+  } else {
+    this->lastFrameTime = now;
+  }
+
+  return Napi::Number::New(env, 0);
+}
+
+// called while too many frames are in flight, waits on the frame fence until the
+// GPU finished the oldest of them, returns true as long as it is still waiting
+// dawn only calls the completion callback during device ticks
+Napi::Value GPUSwapChain::waitFrame(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (this->frameFence == nullptr || this->framesPresented < this->maxFramesInFlight) {
+    return Napi::Boolean::New(env, false);
+  }
+
+  if (this->frameWait == nullptr) {
+    this->frameWait = new FrameWait{ this };
+    wgpuFenceOnCompletion(
+      this->frameFence,
+      this->framesPresented - this->maxFramesInFlight + 1,
+      [](WGPUFenceCompletionStatus status, void* userdata) {
+        FrameWait* frameWait = reinterpret_cast<FrameWait*>(userdata);
+        if (frameWait->swapChain != nullptr) frameWait->swapChain->frameWait = nullptr;
+        delete frameWait;
+      },
+      this->frameWait
+    );
+  }
+
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  wgpuDeviceTick(device->instance);
+
+  return Napi::Boolean::New(env, this->frameWait != nullptr);
+}
+
+Napi::Value GPUSwapChain::setFramePacing(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  Napi::Object options = info[0].As<Napi::Object>();
+  if (options.Has("maxFramesInFlight")) {
+    this->maxFramesInFlight = std::max(options.Get("maxFramesInFlight").As<Napi::Number>().Uint32Value(), 1u);
+  }
+  if (options.Has("targetFrameRate")) {
+    this->targetFrameRate = std::max(options.Get("targetFrameRate").As<Napi::Number>().DoubleValue(), 0.0);
+  }
 
   return env.Undefined();
 }
 
+Napi::Value GPUSwapChain::getFrameTiming(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  uint64_t framesInFlight = 0;
+  if (this->frameFence != nullptr) {
+    framesInFlight = this->framesPresented - wgpuFenceGetCompletedValue(this->frameFence);
+  }
+
+  double mean = 0.0;
+  double jitter = 0.0;
+  uint64_t minFrameTime = 0;
+  uint64_t maxFrameTime = 0;
+  uint64_t latestFrameTime = 0;
+  if (!this->frameTimes.empty()) {
+    double sum = 0.0;
+    minFrameTime = this->frameTimes[0];
+    for (uint64_t frameTime : this->frameTimes) {
+      sum += static_cast<double>(frameTime);
+      minFrameTime = std::min(minFrameTime, frameTime);
+      maxFrameTime = std::max(maxFrameTime, frameTime);
+    };
+    mean = sum / this->frameTimes.size();
+    // jitter is the standard deviation of the frame times
+    double variance = 0.0;
+    for (uint64_t frameTime : this->frameTimes) {
+      double delta = static_cast<double>(frameTime) - mean;
+      variance += delta * delta;
+    };
+    jitter = std::sqrt(variance / this->frameTimes.size());
+    uint32_t lastIndex = (this->frameTimeIndex + kFrameTimeHistorySize - 1) % kFrameTimeHistorySize;
+    latestFrameTime = this->frameTimes[lastIndex];
+  }
+
+  // times are in milliseconds
+  Napi::Object out = Napi::Object::New(env);
+  out.Set("framesPresented", Napi::Number::New(env, static_cast<double>(this->framesPresented)));
+  out.Set("framesInFlight", Napi::Number::New(env, static_cast<double>(framesInFlight)));
+  out.Set("maxFramesInFlight", Napi::Number::New(env, this->maxFramesInFlight));
+  out.Set("targetFrameRate", Napi::Number::New(env, this->targetFrameRate));
+  out.Set("frameTime", Napi::Number::New(env, latestFrameTime * 1e-6));
+  out.Set("meanFrameTime", Napi::Number::New(env, mean * 1e-6));
+  out.Set("minFrameTime", Napi::Number::New(env, minFrameTime * 1e-6));
+  out.Set("maxFrameTime", Napi::Number::New(env, maxFrameTime * 1e-6));
+  out.Set("jitter", Napi::Number::New(env, jitter * 1e-6));
+  return out;
+}
+
 Napi::Object GPUSwapChain::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPUSwapChain", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUSwapChain",
       "getCurrentTextureView",
       &GPUSwapChain::getCurrentTextureView,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUSwapChain",
       "present",
       &GPUSwapChain::present,
       napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUSwapChain",
+      "_tickFrame",
+      &GPUSwapChain::tickFrame,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUSwapChain",
+      "_waitFrame",
+      &GPUSwapChain::waitFrame,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUSwapChain",
+      "setFramePacing",
+      &GPUSwapChain::setFramePacing,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "GPUSwapChain",
+      "getFrameTiming",
+      &GPUSwapChain::getFrameTiming,
+      napi_enumerable
     )
   });
   constructor = Napi::Persistent(func);
@@ -3,6 +3,11 @@
 
 #include "Base.h"
 
+#include <vector>
+
+class GPUQueue;
+class WebGPUWindow;
+
 class GPUSwapChain : public Napi::ObjectWrap<GPUSwapChain> {
 
   public:
@@ -16,13 +21,53 @@ class GPUSwapChain : public Napi::ObjectWrap<GPUSwapChain> {
     Napi::Value getCurrentTextureView(const Napi::CallbackInfo &info);
     Napi::Value present(const Napi::CallbackInfo &info);
 
+    // presents without flushing submits or ending the frame, see 'GPUDevice::presentAll'
+    void presentFrame(GPUQueue* queue);
+
+    Napi::Value tickFrame(const Napi::CallbackInfo &info);
+    Napi::Value waitFrame(const Napi::CallbackInfo &info);
+    Napi::Value setFramePacing(const Napi::CallbackInfo &info);
+    Napi::Value getFrameTiming(const Napi::CallbackInfo &info);
+
     Napi::ObjectReference device;
     Napi::ObjectReference context;
 
     WGPUSwapChain instance;
 
+    FrameStats::Tracker frameStats;
+
     WGPUTextureFormat format;
     WGPUTextureUsage usage;
+
+    // a texture was acquired since the last present
+    bool acquired = false;
+
+  private:
+    WebGPUWindow* window = nullptr;
+
+    // each present signals this fence with its frame number, so
+    // the amount of frames the GPU is still working on is known
+    WGPUFence frameFence = nullptr;
+    uint64_t framesPresented = 0;
+
+    // pending completion callback of the frame fence, it outlives the
+    // swapchain if it gets destroyed while waiting, see 'waitFrame'
+    struct FrameWait {
+      GPUSwapChain* swapChain;
+    };
+    FrameWait* frameWait = nullptr;
+
+    uint32_t maxFramesInFlight = 2;
+    // 0 is uncapped
+    double targetFrameRate = 60.0;
+    // scheduled start of the last frame handed out by 'tickFrame'
+    uint64_t lastFrameTime = 0;
+
+    // present-to-present intervals of the last frames in ns
+    static const uint32_t kFrameTimeHistorySize = 120;
+    std::vector<uint64_t> frameTimes;
+    uint32_t frameTimeIndex = 0;
+    uint64_t lastPresentTime = 0;
 };
 
 #endif
@@ -10,6 +10,8 @@ GPUTexture::GPUTexture(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUTex
   Napi::Env env = info.Env();
 
   this->device.Reset(info[0].As<Napi::Object>(), 1);
+  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+  this->frameStats.track(device->frameStats);
 
   // constructor called internally:
   // prevents this constructor to create a new texture,
@@ -17,13 +19,13 @@ GPUTexture::GPUTexture(const Napi::CallbackInfo& info) : Napi::ObjectWrap<GPUTex
   if (info[2].IsBoolean() && info[2].As<Napi::Boolean>().Value() == true) {
     return;
   }
-  GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
 
   auto descriptor = DescriptorDecoder::GPUTextureDescriptor(device, info[1].As<Napi::Value>());
 
   this->instance = wgpuDeviceCreateTexture(device->instance, &descriptor);
 
   this->dimension = (&descriptor)->dimension;
+  this->format = (&descriptor)->format;
   this->arrayLayerCount = (&descriptor)->arrayLayerCount;
 }
 
@@ -37,7 +39,8 @@ Napi::Value GPUTexture::createView(const Napi::CallbackInfo &info) {
   std::vector<napi_value> args = {
     info.This().As<Napi::Value>()
   };
-  if (info[0].IsObject()) args.push_back(info[0].As<Napi::Value>());
+  // descriptors can also be packed, see 'PackedDescriptors.h'
+  if (info[0].IsObject() || info[0].IsNumber()) args.push_back(info[0].As<Napi::Value>());
   Napi::Object textureView = GPUTextureView::constructor.New(args);
   return textureView;
 }
@@ -48,15 +51,91 @@ Napi::Value GPUTexture::destroy(const Napi::CallbackInfo &info) {
   return env.Undefined();
 }
 
+uint32_t GPUTexture::GetFormatBlockSize(WGPUTextureFormat format) {
+  switch (format) {
+    case WGPUTextureFormat_R8Unorm:
+    case WGPUTextureFormat_R8Snorm:
+    case WGPUTextureFormat_R8Uint:
+    case WGPUTextureFormat_R8Sint:
+      return 1;
+    case WGPUTextureFormat_R16Uint:
+    case WGPUTextureFormat_R16Sint:
+    case WGPUTextureFormat_R16Float:
+    case WGPUTextureFormat_RG8Unorm:
+    case WGPUTextureFormat_RG8Snorm:
+    case WGPUTextureFormat_RG8Uint:
+    case WGPUTextureFormat_RG8Sint:
+      return 2;
+    case WGPUTextureFormat_R32Float:
+    case WGPUTextureFormat_R32Uint:
+    case WGPUTextureFormat_R32Sint:
+    case WGPUTextureFormat_RG16Uint:
+    case WGPUTextureFormat_RG16Sint:
+    case WGPUTextureFormat_RG16Float:
+    case WGPUTextureFormat_RGBA8Unorm:
+    case WGPUTextureFormat_RGBA8UnormSrgb:
+    case WGPUTextureFormat_RGBA8Snorm:
+    case WGPUTextureFormat_RGBA8Uint:
+    case WGPUTextureFormat_RGBA8Sint:
+    case WGPUTextureFormat_BGRA8Unorm:
+    case WGPUTextureFormat_BGRA8UnormSrgb:
+    case WGPUTextureFormat_RGB10A2Unorm:
+    case WGPUTextureFormat_RG11B10Float:
+    case WGPUTextureFormat_Depth32Float:
+    case WGPUTextureFormat_Depth24Plus:
+    case WGPUTextureFormat_Depth24PlusStencil8:
+      return 4;
+    case WGPUTextureFormat_RG32Float:
+    case WGPUTextureFormat_RG32Uint:
+    case WGPUTextureFormat_RG32Sint:
+    case WGPUTextureFormat_RGBA16Uint:
+    case WGPUTextureFormat_RGBA16Sint:
+    case WGPUTextureFormat_RGBA16Float:
+      return 8;
+    case WGPUTextureFormat_RGBA32Float:
+    case WGPUTextureFormat_RGBA32Uint:
+    case WGPUTextureFormat_RGBA32Sint:
+      return 16;
+    case WGPUTextureFormat_BC1RGBAUnorm:
+    case WGPUTextureFormat_BC1RGBAUnormSrgb:
+    case WGPUTextureFormat_BC4RUnorm:
+    case WGPUTextureFormat_BC4RSnorm:
+      return 8;
+    case WGPUTextureFormat_BC2RGBAUnorm:
+    case WGPUTextureFormat_BC2RGBAUnormSrgb:
+    case WGPUTextureFormat_BC3RGBAUnorm:
+    case WGPUTextureFormat_BC3RGBAUnormSrgb:
+    case WGPUTextureFormat_BC5RGUnorm:
+    case WGPUTextureFormat_BC5RGSnorm:
+    case WGPUTextureFormat_BC6HRGBUfloat:
+    case WGPUTextureFormat_BC6HRGBSfloat:
+    case WGPUTextureFormat_BC7RGBAUnorm:
+    case WGPUTextureFormat_BC7RGBAUnormSrgb:
+      return 16;
+    default:
+      return 0;
+  };
+}
+
+uint32_t GPUTexture::GetFormatBlockDimension(WGPUTextureFormat format) {
+  // BC formats are encoded in 4x4 texel blocks
+  if (format >= WGPUTextureFormat_BC1RGBAUnorm && format <= WGPUTextureFormat_BC7RGBAUnormSrgb) {
+    return 4;
+  }
+  return 1;
+}
+
 Napi::Object GPUTexture::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "GPUTexture", {
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUTexture",
       "createView",
       &GPUTexture::createView,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "GPUTexture",
       "destroy",
       &GPUTexture::destroy,
       napi_enumerable
@@ -16,12 +16,19 @@ class GPUTexture : public Napi::ObjectWrap<GPUTexture> {
     Napi::Value createView(const Napi::CallbackInfo &info);
     Napi::Value destroy(const Napi::CallbackInfo &info);
 
+    // byte size and pixel dimension of a single texel block of a format
+    static uint32_t GetFormatBlockSize(WGPUTextureFormat format);
+    static uint32_t GetFormatBlockDimension(WGPUTextureFormat format);
+
     Napi::ObjectReference device;
 
     WGPUTextureDimension dimension;
+    WGPUTextureFormat format;
     uint64_t arrayLayerCount;
 
     WGPUTexture instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
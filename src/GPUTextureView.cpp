@@ -11,6 +11,7 @@ GPUTextureView::GPUTextureView(const Napi::CallbackInfo& info) : Napi::ObjectWra
   // constructor called internally:
   // prevents this constructor to create a new texture,
   // since the texture is expected to be created externally
+  // the creator also tracks the view on the stats of its device
   if (info[2].IsBoolean() && info[2].As<Napi::Boolean>().Value() == true) {
     return;
   }
@@ -18,6 +19,7 @@ GPUTextureView::GPUTextureView(const Napi::CallbackInfo& info) : Napi::ObjectWra
   this->texture.Reset(info[0].As<Napi::Object>(), 1);
   GPUTexture* texture = Napi::ObjectWrap<GPUTexture>::Unwrap(this->texture.Value());
   GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(texture->device.Value());
+  this->frameStats.track(device->frameStats);
 
   auto descriptor = DescriptorDecoder::GPUTextureViewDescriptor(device, info[1].As<Napi::Value>());
 
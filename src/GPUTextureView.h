@@ -16,6 +16,8 @@ class GPUTextureView : public Napi::ObjectWrap<GPUTextureView> {
     Napi::ObjectReference texture;
 
     WGPUTextureView instance;
+
+    FrameStats::Tracker frameStats;
   private:
 
 };
@@ -0,0 +1,580 @@
+#include "ImageBitmap.h"
+#include "JPEGDecoder.h"
+#include "Simd.h"
+
+#include <string>
+#include <cstdlib>
+#include <zlib.h>
+
+Napi::FunctionReference ImageBitmap::constructor;
+
+struct DecodedImage {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<uint8_t> data;
+};
+
+// upper bound for decoded images, to reject corrupted headers early
+static const uint64_t kMaxImageByteLength = 1ull << 30;
+
+static inline uint32_t readUint32BE(const uint8_t* p) {
+  return (
+    (static_cast<uint32_t>(p[0]) << 24) |
+    (static_cast<uint32_t>(p[1]) << 16) |
+    (static_cast<uint32_t>(p[2]) << 8) |
+    (static_cast<uint32_t>(p[3]))
+  );
+}
+
+static inline uint16_t readUint16BE(const uint8_t* p) {
+  return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static inline uint8_t paethPredictor(int a, int b, int c) {
+  int p = a + b - c;
+  int pa = std::abs(p - a);
+  int pb = std::abs(p - b);
+  int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+  if (pb <= pc) return static_cast<uint8_t>(b);
+  return static_cast<uint8_t>(c);
+}
+
+// reverts the per-row filters of a (reduced) image
+static bool unfilterRows(const uint8_t* raw, uint8_t* pixels, uint32_t rows, uint64_t stride, uint32_t bytesPerPixel) {
+  for (uint32_t yy = 0; yy < rows; ++yy) {
+    uint8_t filter = raw[yy * (stride + 1)];
+    const uint8_t* in = &raw[yy * (stride + 1) + 1];
+    uint8_t* row = &pixels[yy * stride];
+    const uint8_t* prev = yy > 0 ? row - stride : nullptr;
+    switch (filter) {
+      // none
+      case 0: {
+        memcpy(row, in, stride);
+      } break;
+      // sub
+      case 1: {
+        for (uint64_t xx = 0; xx < stride; ++xx) {
+          uint8_t a = xx >= bytesPerPixel ? row[xx - bytesPerPixel] : 0;
+          row[xx] = in[xx] + a;
+        };
+      } break;
+      // up
+      case 2: {
+        for (uint64_t xx = 0; xx < stride; ++xx) {
+          uint8_t b = prev ? prev[xx] : 0;
+          row[xx] = in[xx] + b;
+        };
+      } break;
+      // average
+      case 3: {
+        for (uint64_t xx = 0; xx < stride; ++xx) {
+          uint32_t a = xx >= bytesPerPixel ? row[xx - bytesPerPixel] : 0;
+          uint32_t b = prev ? prev[xx] : 0;
+          row[xx] = in[xx] + static_cast<uint8_t>((a + b) >> 1);
+        };
+      } break;
+      // paeth
+      case 4: {
+        for (uint64_t xx = 0; xx < stride; ++xx) {
+          int a = xx >= bytesPerPixel ? row[xx - bytesPerPixel] : 0;
+          int b = prev ? prev[xx] : 0;
+          int c = (prev && xx >= bytesPerPixel) ? prev[xx - bytesPerPixel] : 0;
+          row[xx] = in[xx] + paethPredictor(a, b, c);
+        };
+      } break;
+      default: return false;
+    };
+  };
+  return true;
+}
+
+// x, y, step x and step y of the Adam7 passes
+static const uint32_t kAdam7Passes[7][4] = {
+  { 0, 0, 8, 8 },
+  { 4, 0, 8, 8 },
+  { 0, 4, 4, 8 },
+  { 2, 0, 4, 4 },
+  { 0, 2, 2, 4 },
+  { 1, 0, 2, 2 },
+  { 0, 1, 1, 2 }
+};
+
+// non-interlaced images are a single pass over all pixels
+static const uint32_t kSinglePass[1][4] = {
+  { 0, 0, 1, 1 }
+};
+
+static bool decodePNG(const uint8_t* src, size_t length, DecodedImage& out, std::string& error) {
+  static const uint8_t signature[8] = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+  if (length < 8 || memcmp(src, signature, 8) != 0) {
+    error = "Invalid PNG signature";
+    return false;
+  }
+
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint8_t bitDepth = 0;
+  uint8_t colorType = 0;
+  uint8_t interlace = 0;
+
+  // palette entries are stored as RGBA
+  uint8_t palette[256 * 4];
+  uint32_t paletteSize = 0;
+  for (unsigned int ii = 0; ii < 256; ++ii) {
+    palette[ii * 4 + 0] = 0;
+    palette[ii * 4 + 1] = 0;
+    palette[ii * 4 + 2] = 0;
+    palette[ii * 4 + 3] = 0xFF;
+  };
+
+  bool hasColorKey = false;
+  uint16_t colorKey[3] = { 0, 0, 0 };
+
+  std::vector<uint8_t> compressed;
+
+  size_t offset = 8;
+  while (offset + 12 <= length) {
+    uint32_t chunkLength = readUint32BE(src + offset);
+    const uint8_t* chunkType = src + offset + 4;
+    const uint8_t* chunk = src + offset + 8;
+    if (chunkLength > length - offset - 12) {
+      error = "Truncated PNG chunk";
+      return false;
+    }
+    if (memcmp(chunkType, "IHDR", 4) == 0) {
+      if (chunkLength < 13) {
+        error = "Invalid PNG header";
+        return false;
+      }
+      width = readUint32BE(chunk);
+      height = readUint32BE(chunk + 4);
+      bitDepth = chunk[8];
+      colorType = chunk[9];
+      interlace = chunk[12];
+    }
+    else if (memcmp(chunkType, "PLTE", 4) == 0) {
+      paletteSize = std::min(chunkLength / 3, 256u);
+      for (unsigned int ii = 0; ii < paletteSize; ++ii) {
+        palette[ii * 4 + 0] = chunk[ii * 3 + 0];
+        palette[ii * 4 + 1] = chunk[ii * 3 + 1];
+        palette[ii * 4 + 2] = chunk[ii * 3 + 2];
+      };
+    }
+    else if (memcmp(chunkType, "tRNS", 4) == 0) {
+      if (colorType == 3) {
+        for (unsigned int ii = 0; ii < chunkLength && ii < 256; ++ii) {
+          palette[ii * 4 + 3] = chunk[ii];
+        };
+      }
+      else if (colorType == 0 && chunkLength >= 2) {
+        colorKey[0] = readUint16BE(chunk);
+        hasColorKey = true;
+      }
+      else if (colorType == 2 && chunkLength >= 6) {
+        colorKey[0] = readUint16BE(chunk);
+        colorKey[1] = readUint16BE(chunk + 2);
+        colorKey[2] = readUint16BE(chunk + 4);
+        hasColorKey = true;
+      }
+    }
+    else if (memcmp(chunkType, "IDAT", 4) == 0) {
+      compressed.insert(compressed.end(), chunk, chunk + chunkLength);
+    }
+    else if (memcmp(chunkType, "IEND", 4) == 0) {
+      break;
+    }
+    offset += 12 + chunkLength;
+  };
+
+  if (width == 0 || height == 0 || compressed.empty()) {
+    error = "Invalid or incomplete PNG image";
+    return false;
+  }
+  if (static_cast<uint64_t>(width) * height * 4 > kMaxImageByteLength) {
+    error = "PNG image dimensions are too large";
+    return false;
+  }
+  if (interlace > 1) {
+    error = "Invalid PNG interlace method";
+    return false;
+  }
+
+  uint32_t channels = 0;
+  switch (colorType) {
+    case 0: channels = 1; break; // grayscale
+    case 2: channels = 3; break; // rgb
+    case 3: channels = 1; break; // palette
+    case 4: channels = 2; break; // grayscale alpha
+    case 6: channels = 4; break; // rgba
+    default: {
+      error = "Invalid PNG color type";
+      return false;
+    }
+  };
+  bool validBitDepth = (
+    (bitDepth == 8) ||
+    (bitDepth == 16 && colorType != 3) ||
+    ((bitDepth == 1 || bitDepth == 2 || bitDepth == 4) && (colorType == 0 || colorType == 3))
+  );
+  if (!validBitDepth) {
+    error = "Invalid PNG bit depth";
+    return false;
+  }
+
+  uint32_t bitsPerPixel = channels * bitDepth;
+  uint32_t bytesPerPixel = std::max(bitsPerPixel / 8, 1u);
+
+  // interlaced images are stored as 7 reduced images
+  const uint32_t (*passes)[4] = interlace ? kAdam7Passes : kSinglePass;
+  uint32_t passCount = interlace ? 7 : 1;
+  auto getPassWidth = [width, passes](uint32_t pass) -> uint32_t {
+    return width > passes[pass][0] ? (width - passes[pass][0] + passes[pass][2] - 1) / passes[pass][2] : 0;
+  };
+  auto getPassHeight = [height, passes](uint32_t pass) -> uint32_t {
+    return height > passes[pass][1] ? (height - passes[pass][1] + passes[pass][3] - 1) / passes[pass][3] : 0;
+  };
+  auto getPassStride = [bitsPerPixel](uint32_t passWidth) -> uint64_t {
+    return (static_cast<uint64_t>(passWidth) * bitsPerPixel + 7) / 8;
+  };
+
+  // inflate, each row is prefixed with its filter type, empty passes have no rows
+  uint64_t rawLength = 0;
+  for (uint32_t pass = 0; pass < passCount; ++pass) {
+    uint32_t passWidth = getPassWidth(pass);
+    uint32_t passHeight = getPassHeight(pass);
+    if (passWidth > 0 && passHeight > 0) rawLength += passHeight * (getPassStride(passWidth) + 1);
+  };
+  std::vector<uint8_t> raw(rawLength);
+  uLongf inflatedLength = static_cast<uLongf>(raw.size());
+  int status = uncompress(
+    raw.data(),
+    &inflatedLength,
+    compressed.data(),
+    static_cast<uLong>(compressed.size())
+  );
+  if (status != Z_OK || inflatedLength != raw.size()) {
+    error = "Failed to inflate PNG image data";
+    return false;
+  }
+
+  out.width = width;
+  out.height = height;
+  out.data.resize(static_cast<size_t>(width) * height * 4);
+
+  uint32_t maxSampleValue = (1u << bitDepth) - 1;
+  auto getSample = [bitDepth](const uint8_t* row, uint32_t index) -> uint32_t {
+    if (bitDepth == 8) return row[index];
+    if (bitDepth == 16) return readUint16BE(row + index * 2);
+    uint32_t bitOffset = index * bitDepth;
+    uint32_t shift = 8 - bitDepth - (bitOffset & 7);
+    return (row[bitOffset >> 3] >> shift) & ((1u << bitDepth) - 1);
+  };
+  auto toUnorm8 = [bitDepth, maxSampleValue](uint32_t value) -> uint8_t {
+    if (bitDepth == 8) return static_cast<uint8_t>(value);
+    if (bitDepth == 16) return static_cast<uint8_t>(value >> 8);
+    return static_cast<uint8_t>((value * 255) / maxSampleValue);
+  };
+
+  std::vector<uint8_t> pixels;
+  const uint8_t* passData = raw.data();
+  for (uint32_t pass = 0; pass < passCount; ++pass) {
+    uint32_t passWidth = getPassWidth(pass);
+    uint32_t passHeight = getPassHeight(pass);
+    if (passWidth == 0 || passHeight == 0) continue;
+    uint64_t stride = getPassStride(passWidth);
+
+    pixels.resize(passHeight * stride);
+    if (!unfilterRows(passData, pixels.data(), passHeight, stride, bytesPerPixel)) {
+      error = "Invalid PNG filter type";
+      return false;
+    }
+    passData += passHeight * (stride + 1);
+
+    // fast path, the image is already in the output format
+    if (!interlace && colorType == 6 && bitDepth == 8) {
+      memcpy(out.data.data(), pixels.data(), out.data.size());
+      return true;
+    }
+
+    uint32_t x0 = passes[pass][0];
+    uint32_t y0 = passes[pass][1];
+    uint32_t dx = passes[pass][2];
+    uint32_t dy = passes[pass][3];
+    for (uint32_t yy = 0; yy < passHeight; ++yy) {
+      const uint8_t* row = &pixels[yy * stride];
+      uint8_t* dst = &out.data[(static_cast<size_t>(y0 + yy * dy) * width + x0) * 4];
+      for (uint32_t xx = 0; xx < passWidth; ++xx) {
+        uint32_t index = xx * channels;
+        switch (colorType) {
+          case 0: {
+            uint32_t gray = getSample(row, index);
+            dst[0] = dst[1] = dst[2] = toUnorm8(gray);
+            dst[3] = (hasColorKey && gray == colorKey[0]) ? 0x00 : 0xFF;
+          } break;
+          case 2: {
+            uint32_t r = getSample(row, index + 0);
+            uint32_t g = getSample(row, index + 1);
+            uint32_t b = getSample(row, index + 2);
+            dst[0] = toUnorm8(r);
+            dst[1] = toUnorm8(g);
+            dst[2] = toUnorm8(b);
+            dst[3] = (hasColorKey && r == colorKey[0] && g == colorKey[1] && b == colorKey[2]) ? 0x00 : 0xFF;
+          } break;
+          case 3: {
+            uint32_t entry = getSample(row, index);
+            if (entry >= paletteSize) {
+              error = "Invalid PNG palette index";
+              return false;
+            }
+            memcpy(dst, &palette[entry * 4], 4);
+          } break;
+          case 4: {
+            dst[0] = dst[1] = dst[2] = toUnorm8(getSample(row, index + 0));
+            dst[3] = toUnorm8(getSample(row, index + 1));
+          } break;
+          case 6: {
+            dst[0] = toUnorm8(getSample(row, index + 0));
+            dst[1] = toUnorm8(getSample(row, index + 1));
+            dst[2] = toUnorm8(getSample(row, index + 2));
+            dst[3] = toUnorm8(getSample(row, index + 3));
+          } break;
+        };
+        dst += dx * 4;
+      };
+    };
+  };
+
+  return true;
+}
+
+static bool decodeImage(const uint8_t* src, size_t length, DecodedImage& out, std::string& error) {
+  if (length >= 8 && src[0] == 0x89 && src[1] == 0x50 && src[2] == 0x4E && src[3] == 0x47) {
+    return decodePNG(src, length, out, error);
+  }
+  if (length >= 3 && src[0] == 0xFF && src[1] == 0xD8 && src[2] == 0xFF) {
+    return decodeJPEG(src, length, out.width, out.height, out.data, error);
+  }
+  error = "Unsupported image format";
+  return false;
+}
+
+// decodes the image on the libuv threadpool and resolves with an 'ImageBitmap'
+class ImageDecodeWorker : public Napi::AsyncWorker {
+
+  public:
+
+    ImageDecodeWorker(Napi::Env env, const uint8_t* data, size_t length)
+      : Napi::AsyncWorker(env), deferred(Napi::Promise::Deferred::New(env)), source(data, data + length) { }
+
+    void Execute() override {
+      std::string error;
+      if (!decodeImage(this->source.data(), this->source.size(), this->image, error)) {
+        this->SetError(error);
+      }
+      // release the encoded data as early as possible
+      std::vector<uint8_t>().swap(this->source);
+    }
+
+    void OnOK() override {
+      Napi::Object bitmap = ImageBitmap::constructor.New({});
+      ImageBitmap* uwBitmap = Napi::ObjectWrap<ImageBitmap>::Unwrap(bitmap);
+      uwBitmap->width = this->image.width;
+      uwBitmap->height = this->image.height;
+      uwBitmap->data = std::move(this->image.data);
+      this->deferred.Resolve(bitmap);
+    }
+
+    void OnError(const Napi::Error& error) override {
+      this->deferred.Reject(error.Value());
+    }
+
+    Napi::Promise GetPromise() {
+      return this->deferred.Promise();
+    }
+
+  private:
+    Napi::Promise::Deferred deferred;
+    std::vector<uint8_t> source;
+    DecodedImage image;
+};
+
+// conversion kernels, the template arguments keep the inner loops branch-free,
+// 4 (SSE2) or 8 (NEON) pixels are converted at once and the rest by the scalar loop
+
+static inline uint32_t mulDiv255(uint32_t c, uint32_t a) {
+  uint32_t t = c * a + 128;
+  return (t + (t >> 8)) >> 8;
+}
+
+#if defined(SIMD_SSE2)
+// same rounding as 'mulDiv255', alpha gets multiplied by 255 so it stays the same
+static inline __m128i premultiplySSE2(__m128i pixels, __m128i alphaMask, __m128i alphaOne) {
+  __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+  alpha = _mm_or_si128(_mm_andnot_si128(alphaMask, alpha), alphaOne);
+  __m128i t = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+#endif
+
+template<bool premultiplyAlpha, bool swizzleRB>
+static void convertRow(const uint32_t* src, uint32_t* dst, uint32_t count) {
+  uint32_t ii = 0;
+#if defined(SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+  const __m128i alphaOne = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+  const __m128i maskGA = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+  const __m128i maskLow = _mm_set1_epi32(0xFF);
+  for (; ii + 4 <= count; ii += 4) {
+    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + ii));
+    if (premultiplyAlpha) {
+      __m128i lo = premultiplySSE2(_mm_unpacklo_epi8(p, zero), alphaMask, alphaOne);
+      __m128i hi = premultiplySSE2(_mm_unpackhi_epi8(p, zero), alphaMask, alphaOne);
+      p = _mm_packus_epi16(lo, hi);
+    }
+    if (swizzleRB) {
+      p = _mm_or_si128(
+        _mm_and_si128(p, maskGA),
+        _mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, maskLow), 16), _mm_and_si128(_mm_srli_epi32(p, 16), maskLow))
+      );
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + ii), p);
+  };
+#elif defined(SIMD_NEON)
+  for (; ii + 8 <= count; ii += 8) {
+    uint8x8x4_t p = vld4_u8(reinterpret_cast<const uint8_t*>(src + ii));
+    if (premultiplyAlpha) {
+      // (t + ((t + 128) >> 8) + 128) >> 8, same as 'mulDiv255'
+      for (unsigned int cc = 0; cc < 3; ++cc) {
+        uint16x8_t t = vmull_u8(p.val[cc], p.val[3]);
+        p.val[cc] = vraddhn_u16(t, vrshrq_n_u16(t, 8));
+      };
+    }
+    if (swizzleRB) {
+      uint8x8_t r = p.val[0];
+      p.val[0] = p.val[2];
+      p.val[2] = r;
+    }
+    vst4_u8(reinterpret_cast<uint8_t*>(dst + ii), p);
+  };
+#endif
+  for (; ii < count; ++ii) {
+    uint32_t p = src[ii];
+    if (premultiplyAlpha) {
+      uint32_t a = p >> 24;
+      uint32_t r = mulDiv255(p & 0xFF, a);
+      uint32_t g = mulDiv255((p >> 8) & 0xFF, a);
+      uint32_t b = mulDiv255((p >> 16) & 0xFF, a);
+      p = r | (g << 8) | (b << 16) | (a << 24);
+    }
+    if (swizzleRB) {
+      p = (p & 0xFF00FF00) | ((p & 0xFF) << 16) | ((p >> 16) & 0xFF);
+    }
+    dst[ii] = p;
+  };
+}
+
+ImageBitmap::ImageBitmap(const Napi::CallbackInfo& info) : Napi::ObjectWrap<ImageBitmap>(info) { }
+
+ImageBitmap::~ImageBitmap() { }
+
+bool ImageBitmap::convertTo(
+  WGPUTextureFormat format,
+  bool premultiplyAlpha,
+  uint32_t x,
+  uint32_t y,
+  uint32_t width,
+  uint32_t height,
+  uint8_t* dst,
+  uint64_t dstBytesPerRow
+) {
+  bool swizzleRB = false;
+  switch (format) {
+    case WGPUTextureFormat_RGBA8Unorm:
+    case WGPUTextureFormat_RGBA8UnormSrgb:
+      swizzleRB = false;
+    break;
+    case WGPUTextureFormat_BGRA8Unorm:
+    case WGPUTextureFormat_BGRA8UnormSrgb:
+      swizzleRB = true;
+    break;
+    default:
+      return false;
+  };
+  for (uint32_t yy = 0; yy < height; ++yy) {
+    const uint32_t* srcRow = reinterpret_cast<const uint32_t*>(
+      this->data.data() + (static_cast<uint64_t>(y + yy) * this->width + x) * 4
+    );
+    uint32_t* dstRow = reinterpret_cast<uint32_t*>(dst + dstBytesPerRow * yy);
+    if (premultiplyAlpha) {
+      if (swizzleRB) convertRow<true, true>(srcRow, dstRow, width);
+      else convertRow<true, false>(srcRow, dstRow, width);
+    } else {
+      if (swizzleRB) convertRow<false, true>(srcRow, dstRow, width);
+      else memcpy(dstRow, srcRow, width * 4);
+    }
+  };
+  return true;
+}
+
+Napi::Value ImageBitmap::createImageBitmap(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  size_t length = 0;
+  uint8_t* data = getTypedArrayData<uint8_t>(info[0].As<Napi::Value>(), &length);
+  if (data == nullptr) return env.Undefined();
+
+  ImageDecodeWorker* worker = new ImageDecodeWorker(env, data, length);
+  Napi::Promise promise = worker->GetPromise();
+  worker->Queue();
+
+  return promise;
+}
+
+Napi::Value ImageBitmap::GetWidth(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  return Napi::Number::New(env, this->width);
+}
+
+Napi::Value ImageBitmap::GetHeight(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  return Napi::Number::New(env, this->height);
+}
+
+Napi::Value ImageBitmap::close(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  std::vector<uint8_t>().swap(this->data);
+  this->width = 0;
+  this->height = 0;
+  return env.Undefined();
+}
+
+Napi::Object ImageBitmap::Initialize(Napi::Env env, Napi::Object exports) {
+  Napi::HandleScope scope(env);
+  Napi::Function func = DefineClass(env, "ImageBitmap", {
+    InstanceAccessor(
+      "width",
+      &ImageBitmap::GetWidth,
+      nullptr,
+      napi_enumerable
+    ),
+    InstanceAccessor(
+      "height",
+      &ImageBitmap::GetHeight,
+      nullptr,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "ImageBitmap",
+      "close",
+      &ImageBitmap::close,
+      napi_enumerable
+    )
+  });
+  constructor = Napi::Persistent(func);
+  constructor.SuppressDestruct();
+  exports.Set("ImageBitmap", func);
+  exports.Set("createImageBitmap", Napi::Function::New(env, &ImageBitmap::createImageBitmap, "createImageBitmap"));
+  return exports;
+}
@@ -0,0 +1,45 @@
+#ifndef __IMAGE_BITMAP_H__
+#define __IMAGE_BITMAP_H__
+
+#include "Base.h"
+
+#include <vector>
+
+class ImageBitmap : public Napi::ObjectWrap<ImageBitmap> {
+
+  public:
+
+    static Napi::Object Initialize(Napi::Env env, Napi::Object exports);
+    static Napi::FunctionReference constructor;
+
+    static Napi::Value createImageBitmap(const Napi::CallbackInfo &info);
+
+    ImageBitmap(const Napi::CallbackInfo &info);
+    ~ImageBitmap();
+
+    // #accessors
+    Napi::Value GetWidth(const Napi::CallbackInfo &info);
+    Napi::Value GetHeight(const Napi::CallbackInfo &info);
+
+    Napi::Value close(const Napi::CallbackInfo &info);
+
+    // writes a region of this bitmap into 'dst' using the given texture format
+    bool convertTo(
+      WGPUTextureFormat format,
+      bool premultiplyAlpha,
+      uint32_t x,
+      uint32_t y,
+      uint32_t width,
+      uint32_t height,
+      uint8_t* dst,
+      uint64_t dstBytesPerRow
+    );
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    // decoded pixels, always RGBA8 with straight alpha
+    std::vector<uint8_t> data;
+};
+
+#endif
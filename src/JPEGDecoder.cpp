@@ -0,0 +1,1034 @@
+#include "JPEGDecoder.h"
+#include "Simd.h"
+
+#include <cstring>
+#include <algorithm>
+
+// upper bound for decoded images, to reject corrupted headers early
+static const uint64_t kMaxImageByteLength = 1ull << 30;
+
+// huffman codes of up to this length are resolved with a single lookup
+static const uint32_t kHuffmanLookupBits = 9;
+
+// natural order index of the zigzag ordered coefficients
+static const uint8_t kZigZag[64] = {
+  0,  1,  8,  16, 9,  2,  3,  10,
+  17, 24, 32, 25, 18, 11, 4,  5,
+  12, 19, 26, 33, 40, 48, 41, 34,
+  27, 20, 13, 6,  7,  14, 21, 28,
+  35, 42, 49, 56, 57, 50, 43, 36,
+  29, 22, 15, 23, 30, 37, 44, 51,
+  58, 59, 52, 45, 38, 31, 39, 46,
+  53, 60, 61, 54, 47, 55, 62, 63
+};
+
+struct HuffmanTable {
+  bool defined = false;
+  // entries are (length << 8) | value, 0 for codes longer than the lookup
+  uint16_t lookup[1 << kHuffmanLookupBits];
+  int32_t maxCode[17];
+  int32_t valueOffset[17];
+  uint8_t values[256];
+  uint32_t valueCount = 0;
+};
+
+struct Component {
+  uint8_t id = 0;
+  uint32_t h = 1;
+  uint32_t v = 1;
+  uint32_t quantTable = 0;
+  uint32_t dcTable = 0;
+  uint32_t acTable = 0;
+  // the quantization table is latched by the first scan of the component
+  bool quantLatched = false;
+  uint16_t quant[64];
+  // amount of samples without the padding of the blocks
+  uint32_t sampleWidth = 0;
+  uint32_t sampleHeight = 0;
+  // padded to whole MCUs
+  uint32_t blocksPerLine = 0;
+  uint32_t blocksPerColumn = 0;
+  int32_t dcPredictor = 0;
+  // 64 per block in natural order
+  std::vector<int16_t> coefficients;
+  std::vector<uint8_t> samples;
+};
+
+struct JPEGState {
+  uint16_t quantTables[4][64];
+  bool quantDefined[4] = { false, false, false, false };
+  HuffmanTable dcTables[4];
+  HuffmanTable acTables[4];
+  Component components[3];
+  uint32_t componentCount = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t hMax = 1;
+  uint32_t vMax = 1;
+  uint32_t mcusPerLine = 0;
+  uint32_t mcusPerColumn = 0;
+  bool frameDefined = false;
+  bool progressive = false;
+  uint32_t restartInterval = 0;
+  uint32_t eobrun = 0;
+  bool adobe = false;
+  uint8_t adobeTransform = 0;
+};
+
+enum ScanMode {
+  SCAN_SEQUENTIAL,
+  SCAN_DC_FIRST,
+  SCAN_DC_REFINE,
+  SCAN_AC_FIRST,
+  SCAN_AC_REFINE
+};
+
+static inline uint16_t readUint16BE(const uint8_t* p) {
+  return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static inline uint8_t clampToUint8(int32_t value) {
+  return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// reads the entropy coded segment of a scan, stuffed zero bytes are removed
+// and once a marker is reached, zeros are returned
+class BitReader {
+
+  public:
+
+    BitReader(const uint8_t* data, size_t length, size_t offset) : data(data), length(length), offset(offset) { }
+
+    inline uint32_t peek16() {
+      this->fill();
+      return this->buffer >> 16;
+    };
+
+    inline void skip(uint32_t count) {
+      this->buffer <<= count;
+      this->bits -= count;
+    };
+
+    inline uint32_t getBits(uint32_t count) {
+      if (count == 0) return 0;
+      this->fill();
+      uint32_t value = this->buffer >> (32 - count);
+      this->skip(count);
+      return value;
+    };
+
+    // values with a leading zero bit are negative
+    inline int32_t receiveExtend(uint32_t count) {
+      if (count == 0) return 0;
+      int32_t value = static_cast<int32_t>(this->getBits(count));
+      if (value < (1 << (count - 1))) value -= (1 << count) - 1;
+      return value;
+    };
+
+    inline int32_t decode(const HuffmanTable& table) {
+      uint32_t bits = this->peek16();
+      uint16_t entry = table.lookup[bits >> (16 - kHuffmanLookupBits)];
+      if (entry != 0) {
+        this->skip(entry >> 8);
+        return entry & 0xFF;
+      }
+      for (uint32_t length = kHuffmanLookupBits + 1; length <= 16; ++length) {
+        int32_t code = static_cast<int32_t>(bits >> (16 - length));
+        if (code <= table.maxCode[length]) {
+          int32_t index = code + table.valueOffset[length];
+          if (index < 0 || index >= static_cast<int32_t>(table.valueCount)) return -1;
+          this->skip(length);
+          return table.values[index];
+        }
+      };
+      return -1;
+    };
+
+    // drops the buffered bits and steps over the next restart marker
+    bool restart() {
+      this->buffer = 0;
+      this->bits = 0;
+      while (this->offset + 1 < this->length) {
+        if (this->data[this->offset] == 0xFF) {
+          uint8_t next = this->data[this->offset + 1];
+          if (next >= 0xD0 && next <= 0xD7) {
+            this->offset += 2;
+            this->marker = false;
+            return true;
+          }
+          if (next != 0x00 && next != 0xFF) break;
+        }
+        this->offset++;
+      };
+      this->marker = true;
+      return false;
+    };
+
+    size_t getOffset() const {
+      return this->offset;
+    };
+
+  private:
+
+    void fill() {
+      while (this->bits <= 24) {
+        uint32_t byte = 0;
+        if (!this->marker && this->offset < this->length) {
+          byte = this->data[this->offset];
+          if (byte == 0xFF) {
+            uint8_t next = this->offset + 1 < this->length ? this->data[this->offset + 1] : 0xD9;
+            if (next == 0x00) {
+              this->offset += 2;
+            } else {
+              this->marker = true;
+              byte = 0;
+            }
+          } else {
+            this->offset++;
+          }
+        }
+        this->buffer |= byte << (24 - this->bits);
+        this->bits += 8;
+      };
+    };
+
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t offset = 0;
+    uint32_t buffer = 0;
+    int32_t bits = 0;
+    bool marker = false;
+};
+
+static bool buildHuffmanTable(HuffmanTable& table, const uint8_t* counts, const uint8_t* values, uint32_t valueCount) {
+  memset(table.lookup, 0, sizeof(table.lookup));
+  memcpy(table.values, values, valueCount);
+  table.valueCount = valueCount;
+  int32_t code = 0;
+  uint32_t index = 0;
+  for (uint32_t length = 1; length <= 16; ++length) {
+    uint32_t count = counts[length - 1];
+    table.valueOffset[length] = static_cast<int32_t>(index) - code;
+    for (uint32_t ii = 0; ii < count; ++ii) {
+      // the codes of a length have to fit into the length
+      if (code >= (1 << length)) return false;
+      if (length <= kHuffmanLookupBits) {
+        uint32_t shift = kHuffmanLookupBits - length;
+        uint32_t first = static_cast<uint32_t>(code) << shift;
+        for (uint32_t jj = 0; jj < (1u << shift); ++jj) {
+          table.lookup[first + jj] = static_cast<uint16_t>((length << 8) | values[index]);
+        };
+      }
+      code++;
+      index++;
+    };
+    table.maxCode[length] = count > 0 ? code - 1 : -1;
+    code <<= 1;
+  };
+  table.defined = true;
+  return true;
+}
+
+static bool decodeBlockSequential(BitReader& reader, JPEGState& jpeg, Component& component, int16_t* block, uint32_t ss, uint32_t se, uint32_t al) {
+  const HuffmanTable& dc = jpeg.dcTables[component.dcTable];
+  const HuffmanTable& ac = jpeg.acTables[component.acTable];
+  int32_t t = reader.decode(dc);
+  if (t < 0 || t > 16) return false;
+  component.dcPredictor += reader.receiveExtend(t);
+  block[0] = static_cast<int16_t>(component.dcPredictor);
+  for (uint32_t k = 1; k < 64;) {
+    int32_t rs = reader.decode(ac);
+    if (rs < 0) return false;
+    uint32_t s = rs & 15;
+    uint32_t r = rs >> 4;
+    if (s == 0) {
+      if (r != 15) break;
+      k += 16;
+      continue;
+    }
+    k += r;
+    if (k > 63) return false;
+    block[kZigZag[k]] = static_cast<int16_t>(reader.receiveExtend(s));
+    k++;
+  };
+  return true;
+}
+
+static bool decodeBlockDCFirst(BitReader& reader, JPEGState& jpeg, Component& component, int16_t* block, uint32_t ss, uint32_t se, uint32_t al) {
+  int32_t t = reader.decode(jpeg.dcTables[component.dcTable]);
+  if (t < 0 || t > 16) return false;
+  component.dcPredictor += reader.receiveExtend(t);
+  block[0] = static_cast<int16_t>(component.dcPredictor * (1 << al));
+  return true;
+}
+
+static bool decodeBlockDCRefine(BitReader& reader, JPEGState& jpeg, Component& component, int16_t* block, uint32_t ss, uint32_t se, uint32_t al) {
+  if (reader.getBits(1)) block[0] |= static_cast<int16_t>(1 << al);
+  return true;
+}
+
+static bool decodeBlockACFirst(BitReader& reader, JPEGState& jpeg, Component& component, int16_t* block, uint32_t ss, uint32_t se, uint32_t al) {
+  if (jpeg.eobrun > 0) {
+    jpeg.eobrun--;
+    return true;
+  }
+  const HuffmanTable& ac = jpeg.acTables[component.acTable];
+  for (uint32_t k = ss; k <= se;) {
+    int32_t rs = reader.decode(ac);
+    if (rs < 0) return false;
+    uint32_t s = rs & 15;
+    uint32_t r = rs >> 4;
+    if (s == 0) {
+      if (r < 15) {
+        // end of band run, includes this block
+        jpeg.eobrun = (1u << r) - 1;
+        if (r > 0) jpeg.eobrun += reader.getBits(r);
+        break;
+      }
+      k += 16;
+      continue;
+    }
+    k += r;
+    if (k > 63) return false;
+    block[kZigZag[k]] = static_cast<int16_t>(reader.receiveExtend(s) * (1 << al));
+    k++;
+  };
+  return true;
+}
+
+// refines the already non-zero coefficients and places the new ones of this band
+static bool decodeBlockACRefine(BitReader& reader, JPEGState& jpeg, Component& component, int16_t* block, uint32_t ss, uint32_t se, uint32_t al) {
+  int16_t bit = static_cast<int16_t>(1 << al);
+  auto refine = [&reader, bit](int16_t* coefficient) {
+    if (reader.getBits(1) && (*coefficient & bit) == 0) {
+      if (*coefficient > 0) *coefficient += bit;
+      else *coefficient -= bit;
+    }
+  };
+  if (jpeg.eobrun > 0) {
+    jpeg.eobrun--;
+    for (uint32_t k = ss; k <= se; ++k) {
+      int16_t* coefficient = &block[kZigZag[k]];
+      if (*coefficient != 0) refine(coefficient);
+    };
+    return true;
+  }
+  const HuffmanTable& ac = jpeg.acTables[component.acTable];
+  uint32_t k = ss;
+  while (k <= se) {
+    int32_t rs = reader.decode(ac);
+    if (rs < 0) return false;
+    uint32_t s = rs & 15;
+    uint32_t r = rs >> 4;
+    int16_t value = 0;
+    if (s == 0) {
+      if (r < 15) {
+        jpeg.eobrun = (1u << r) - 1;
+        if (r > 0) jpeg.eobrun += reader.getBits(r);
+        // refine the rest of this block, without placing new coefficients
+        r = 64;
+      }
+    } else {
+      if (s != 1) return false;
+      value = reader.getBits(1) ? bit : static_cast<int16_t>(-bit);
+    }
+    while (k <= se) {
+      int16_t* coefficient = &block[kZigZag[k++]];
+      if (*coefficient != 0) {
+        refine(coefficient);
+      } else {
+        if (r == 0) {
+          *coefficient = value;
+          break;
+        }
+        r--;
+      }
+    };
+  };
+  return true;
+}
+
+typedef bool (*DecodeBlockFunction)(BitReader&, JPEGState&, Component&, int16_t*, uint32_t, uint32_t, uint32_t);
+
+static bool decodeScan(
+  JPEGState& jpeg,
+  const uint8_t* data,
+  size_t length,
+  size_t& offset,
+  Component** components,
+  uint32_t componentCount,
+  ScanMode mode,
+  uint32_t ss,
+  uint32_t se,
+  uint32_t al
+) {
+  DecodeBlockFunction decodeBlock = nullptr;
+  switch (mode) {
+    case SCAN_SEQUENTIAL: decodeBlock = decodeBlockSequential; break;
+    case SCAN_DC_FIRST: decodeBlock = decodeBlockDCFirst; break;
+    case SCAN_DC_REFINE: decodeBlock = decodeBlockDCRefine; break;
+    case SCAN_AC_FIRST: decodeBlock = decodeBlockACFirst; break;
+    case SCAN_AC_REFINE: decodeBlock = decodeBlockACRefine; break;
+  };
+
+  BitReader reader(data, length, offset);
+  auto resetPredictors = [&jpeg, components, componentCount]() {
+    for (uint32_t ii = 0; ii < componentCount; ++ii) components[ii]->dcPredictor = 0;
+    jpeg.eobrun = 0;
+  };
+  resetPredictors();
+
+  // non-interleaved scans only cover the blocks inside of the image
+  if (componentCount == 1) {
+    Component& component = *components[0];
+    uint32_t blocksX = (component.sampleWidth + 7) / 8;
+    uint32_t blocksY = (component.sampleHeight + 7) / 8;
+    uint64_t count = static_cast<uint64_t>(blocksX) * blocksY;
+    for (uint64_t ii = 0; ii < count; ++ii) {
+      if (jpeg.restartInterval > 0 && ii > 0 && (ii % jpeg.restartInterval) == 0) {
+        reader.restart();
+        resetPredictors();
+      }
+      uint64_t bx = ii % blocksX;
+      uint64_t by = ii / blocksX;
+      int16_t* block = &component.coefficients[(by * component.blocksPerLine + bx) * 64];
+      if (!decodeBlock(reader, jpeg, component, block, ss, se, al)) return false;
+    };
+  }
+  else {
+    uint64_t count = static_cast<uint64_t>(jpeg.mcusPerLine) * jpeg.mcusPerColumn;
+    for (uint64_t ii = 0; ii < count; ++ii) {
+      if (jpeg.restartInterval > 0 && ii > 0 && (ii % jpeg.restartInterval) == 0) {
+        reader.restart();
+        resetPredictors();
+      }
+      uint64_t mx = ii % jpeg.mcusPerLine;
+      uint64_t my = ii / jpeg.mcusPerLine;
+      for (uint32_t cc = 0; cc < componentCount; ++cc) {
+        Component& component = *components[cc];
+        for (uint32_t vv = 0; vv < component.v; ++vv) {
+          for (uint32_t hh = 0; hh < component.h; ++hh) {
+            uint64_t bx = mx * component.h + hh;
+            uint64_t by = my * component.v + vv;
+            int16_t* block = &component.coefficients[(by * component.blocksPerLine + bx) * 64];
+            if (!decodeBlock(reader, jpeg, component, block, ss, se, al)) return false;
+          };
+        };
+      };
+    };
+  }
+
+  offset = reader.getOffset();
+  return true;
+}
+
+// integer inverse dct, same as libjpeg's 'islow'
+static const int32_t kConstBits = 13;
+static const int32_t kPass1Bits = 2;
+
+#define FIX_0_298631336 2446
+#define FIX_0_390180644 3196
+#define FIX_0_541196100 4433
+#define FIX_0_765366865 6270
+#define FIX_0_899976223 7373
+#define FIX_1_175875602 9633
+#define FIX_1_501321110 12299
+#define FIX_1_847759065 15137
+#define FIX_1_961570560 16069
+#define FIX_2_053119869 16819
+#define FIX_2_562915447 20995
+#define FIX_3_072711026 25172
+
+static inline int32_t descale(int32_t value, int32_t bits) {
+  return (value + (1 << (bits - 1))) >> bits;
+}
+
+static void idctBlock(const int16_t* in, const uint16_t* quant, uint8_t* out, uint32_t stride) {
+  int32_t workspace[64];
+
+  // columns
+  for (uint32_t cc = 0; cc < 8; ++cc) {
+    const int16_t* col = in + cc;
+    const uint16_t* q = quant + cc;
+    int32_t* ws = workspace + cc;
+    if (
+      col[8 * 1] == 0 && col[8 * 2] == 0 && col[8 * 3] == 0 && col[8 * 4] == 0 &&
+      col[8 * 5] == 0 && col[8 * 6] == 0 && col[8 * 7] == 0
+    ) {
+      int32_t dc = (col[0] * q[0]) * (1 << kPass1Bits);
+      for (uint32_t rr = 0; rr < 8; ++rr) ws[8 * rr] = dc;
+      continue;
+    }
+    // even part
+    int32_t z2 = col[8 * 2] * q[8 * 2];
+    int32_t z3 = col[8 * 6] * q[8 * 6];
+    int32_t z1 = (z2 + z3) * FIX_0_541196100;
+    int32_t tmp2 = z1 + z3 * (-FIX_1_847759065);
+    int32_t tmp3 = z1 + z2 * FIX_0_765366865;
+    z2 = col[8 * 0] * q[8 * 0];
+    z3 = col[8 * 4] * q[8 * 4];
+    int32_t tmp0 = (z2 + z3) * (1 << kConstBits);
+    int32_t tmp1 = (z2 - z3) * (1 << kConstBits);
+    int32_t tmp10 = tmp0 + tmp3;
+    int32_t tmp13 = tmp0 - tmp3;
+    int32_t tmp11 = tmp1 + tmp2;
+    int32_t tmp12 = tmp1 - tmp2;
+    // odd part
+    tmp0 = col[8 * 7] * q[8 * 7];
+    tmp1 = col[8 * 5] * q[8 * 5];
+    tmp2 = col[8 * 3] * q[8 * 3];
+    tmp3 = col[8 * 1] * q[8 * 1];
+    z1 = tmp0 + tmp3;
+    z2 = tmp1 + tmp2;
+    z3 = tmp0 + tmp2;
+    int32_t z4 = tmp1 + tmp3;
+    int32_t z5 = (z3 + z4) * FIX_1_175875602;
+    tmp0 *= FIX_0_298631336;
+    tmp1 *= FIX_2_053119869;
+    tmp2 *= FIX_3_072711026;
+    tmp3 *= FIX_1_501321110;
+    z1 *= -FIX_0_899976223;
+    z2 *= -FIX_2_562915447;
+    z3 *= -FIX_1_961570560;
+    z4 *= -FIX_0_390180644;
+    z3 += z5;
+    z4 += z5;
+    tmp0 += z1 + z3;
+    tmp1 += z2 + z4;
+    tmp2 += z2 + z3;
+    tmp3 += z1 + z4;
+    ws[8 * 0] = descale(tmp10 + tmp3, kConstBits - kPass1Bits);
+    ws[8 * 7] = descale(tmp10 - tmp3, kConstBits - kPass1Bits);
+    ws[8 * 1] = descale(tmp11 + tmp2, kConstBits - kPass1Bits);
+    ws[8 * 6] = descale(tmp11 - tmp2, kConstBits - kPass1Bits);
+    ws[8 * 2] = descale(tmp12 + tmp1, kConstBits - kPass1Bits);
+    ws[8 * 5] = descale(tmp12 - tmp1, kConstBits - kPass1Bits);
+    ws[8 * 3] = descale(tmp13 + tmp0, kConstBits - kPass1Bits);
+    ws[8 * 4] = descale(tmp13 - tmp0, kConstBits - kPass1Bits);
+  };
+
+  // rows, the level shift is folded into the rounding
+  const int32_t shift = kConstBits + kPass1Bits + 3;
+  for (uint32_t rr = 0; rr < 8; ++rr) {
+    const int32_t* ws = workspace + rr * 8;
+    uint8_t* row = out + stride * rr;
+    if (ws[1] == 0 && ws[2] == 0 && ws[3] == 0 && ws[4] == 0 && ws[5] == 0 && ws[6] == 0 && ws[7] == 0) {
+      uint8_t dc = clampToUint8(descale(ws[0], kPass1Bits + 3) + 128);
+      memset(row, dc, 8);
+      continue;
+    }
+    // even part
+    int32_t z2 = ws[2];
+    int32_t z3 = ws[6];
+    int32_t z1 = (z2 + z3) * FIX_0_541196100;
+    int32_t tmp2 = z1 + z3 * (-FIX_1_847759065);
+    int32_t tmp3 = z1 + z2 * FIX_0_765366865;
+    int32_t tmp0 = (ws[0] + ws[4]) * (1 << kConstBits);
+    int32_t tmp1 = (ws[0] - ws[4]) * (1 << kConstBits);
+    int32_t tmp10 = tmp0 + tmp3;
+    int32_t tmp13 = tmp0 - tmp3;
+    int32_t tmp11 = tmp1 + tmp2;
+    int32_t tmp12 = tmp1 - tmp2;
+    // odd part
+    tmp0 = ws[7];
+    tmp1 = ws[5];
+    tmp2 = ws[3];
+    tmp3 = ws[1];
+    z1 = tmp0 + tmp3;
+    z2 = tmp1 + tmp2;
+    z3 = tmp0 + tmp2;
+    int32_t z4 = tmp1 + tmp3;
+    int32_t z5 = (z3 + z4) * FIX_1_175875602;
+    tmp0 *= FIX_0_298631336;
+    tmp1 *= FIX_2_053119869;
+    tmp2 *= FIX_3_072711026;
+    tmp3 *= FIX_1_501321110;
+    z1 *= -FIX_0_899976223;
+    z2 *= -FIX_2_562915447;
+    z3 *= -FIX_1_961570560;
+    z4 *= -FIX_0_390180644;
+    z3 += z5;
+    z4 += z5;
+    tmp0 += z1 + z3;
+    tmp1 += z2 + z4;
+    tmp2 += z2 + z3;
+    tmp3 += z1 + z4;
+    row[0] = clampToUint8(descale(tmp10 + tmp3, shift) + 128);
+    row[7] = clampToUint8(descale(tmp10 - tmp3, shift) + 128);
+    row[1] = clampToUint8(descale(tmp11 + tmp2, shift) + 128);
+    row[6] = clampToUint8(descale(tmp11 - tmp2, shift) + 128);
+    row[2] = clampToUint8(descale(tmp12 + tmp1, shift) + 128);
+    row[5] = clampToUint8(descale(tmp12 - tmp1, shift) + 128);
+    row[3] = clampToUint8(descale(tmp13 + tmp0, shift) + 128);
+    row[4] = clampToUint8(descale(tmp13 - tmp0, shift) + 128);
+  };
+}
+
+// chroma upsampling, the common 2x1 and 2x2 subsamplings are interpolated
+// like libjpeg's "fancy" upsampling, the other ones and very narrow
+// components get replicated, same as libjpeg does
+
+static void upsampleH2V1(uint8_t* out, const uint8_t* in, uint32_t width) {
+  out[0] = in[0];
+  out[1] = static_cast<uint8_t>((in[0] * 3 + in[1] + 2) >> 2);
+  uint32_t ii = 1;
+  for (; ii < width - 1; ++ii) {
+    uint32_t n = in[ii] * 3 + 2;
+    out[ii * 2 + 0] = static_cast<uint8_t>((n + in[ii - 1]) >> 2);
+    out[ii * 2 + 1] = static_cast<uint8_t>((n + in[ii + 1]) >> 2);
+  };
+  out[ii * 2 + 0] = static_cast<uint8_t>((in[width - 2] + in[width - 1] * 3 + 2) >> 2);
+  out[ii * 2 + 1] = in[width - 1];
+}
+
+static void upsampleH2V2(uint8_t* out, const uint8_t* nearRow, const uint8_t* farRow, uint32_t width) {
+  uint32_t t1 = nearRow[0] * 3 + farRow[0];
+  out[0] = static_cast<uint8_t>((t1 + 2) >> 2);
+  for (uint32_t ii = 1; ii < width; ++ii) {
+    uint32_t t0 = t1;
+    t1 = nearRow[ii] * 3 + farRow[ii];
+    out[ii * 2 - 1] = static_cast<uint8_t>((t0 * 3 + t1 + 8) >> 4);
+    out[ii * 2 + 0] = static_cast<uint8_t>((t1 * 3 + t0 + 8) >> 4);
+  };
+  out[width * 2 - 1] = static_cast<uint8_t>((t1 + 2) >> 2);
+}
+
+// returns row 'y' of the component at full resolution, 'scratch' is used for subsampled components
+static const uint8_t* getComponentRow(const JPEGState& jpeg, const Component& component, uint32_t y, uint8_t* scratch) {
+  uint32_t stride = component.blocksPerLine * 8;
+  const uint8_t* samples = component.samples.data();
+  if (component.h == jpeg.hMax && component.v == jpeg.vMax) {
+    return samples + static_cast<size_t>(y) * stride;
+  }
+  bool interpolate = component.sampleWidth > 2;
+  if (interpolate && component.h * 2 == jpeg.hMax && component.v == jpeg.vMax) {
+    upsampleH2V1(scratch, samples + static_cast<size_t>(y) * stride, component.sampleWidth);
+    return scratch;
+  }
+  if (interpolate && component.h * 2 == jpeg.hMax && component.v * 2 == jpeg.vMax) {
+    uint32_t nearY = y >> 1;
+    uint32_t farY = (y & 1) ? std::min(nearY + 1, component.sampleHeight - 1) : (nearY > 0 ? nearY - 1 : 0);
+    upsampleH2V2(
+      scratch,
+      samples + static_cast<size_t>(nearY) * stride,
+      samples + static_cast<size_t>(farY) * stride,
+      component.sampleWidth
+    );
+    return scratch;
+  }
+  const uint8_t* row = samples + static_cast<size_t>(y * component.v / jpeg.vMax) * stride;
+  for (uint32_t xx = 0; xx < jpeg.width; ++xx) {
+    scratch[xx] = row[xx * component.h / jpeg.hMax];
+  };
+  return scratch;
+}
+
+// YCbCr to RGBA, 14-bit fixed point, so the simd paths can multiply
+// with 16-bit constants and produce the same results as the scalar loop
+static const int16_t kCrToR = 22970;
+static const int16_t kCbToG = -5638;
+static const int16_t kCrToG = -11700;
+static const int16_t kCbToB = 29032;
+
+static void convertYCbCrRow(const uint8_t* yRow, const uint8_t* cbRow, const uint8_t* crRow, uint8_t* dst, uint32_t count) {
+  uint32_t ii = 0;
+#if defined(SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i bias = _mm_set1_epi16(128);
+  const __m128i round = _mm_set1_epi32(1 << 13);
+  const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+  // cb and cr get interleaved, so madd computes 'cb * x + cr * y' per pixel
+  const __m128i toR = _mm_setr_epi16(0, kCrToR, 0, kCrToR, 0, kCrToR, 0, kCrToR);
+  const __m128i toG = _mm_setr_epi16(kCbToG, kCrToG, kCbToG, kCrToG, kCbToG, kCrToG, kCbToG, kCrToG);
+  const __m128i toB = _mm_setr_epi16(kCbToB, 0, kCbToB, 0, kCbToB, 0, kCbToB, 0);
+  for (; ii + 8 <= count; ii += 8) {
+    __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(yRow + ii)), zero);
+    __m128i cb = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cbRow + ii)), zero), bias);
+    __m128i cr = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(crRow + ii)), zero), bias);
+    __m128i lo = _mm_unpacklo_epi16(cb, cr);
+    __m128i hi = _mm_unpackhi_epi16(cb, cr);
+    __m128i r = _mm_add_epi16(y, _mm_packs_epi32(
+      _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(lo, toR), round), 14),
+      _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(hi, toR), round), 14)
+    ));
+    __m128i g = _mm_add_epi16(y, _mm_packs_epi32(
+      _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(lo, toG), round), 14),
+      _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(hi, toG), round), 14)
+    ));
+    __m128i b = _mm_add_epi16(y, _mm_packs_epi32(
+      _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(lo, toB), round), 14),
+      _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(hi, toB), round), 14)
+    ));
+    __m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+    __m128i ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + ii * 4 + 0), _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + ii * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+  };
+#elif defined(SIMD_NEON)
+  for (; ii + 8 <= count; ii += 8) {
+    int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(yRow + ii)));
+    int16x8_t cb = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(cbRow + ii), vdup_n_u8(128)));
+    int16x8_t cr = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(crRow + ii), vdup_n_u8(128)));
+    int32x4_t rLo = vmull_n_s16(vget_low_s16(cr), kCrToR);
+    int32x4_t rHi = vmull_n_s16(vget_high_s16(cr), kCrToR);
+    int32x4_t gLo = vmlal_n_s16(vmull_n_s16(vget_low_s16(cb), kCbToG), vget_low_s16(cr), kCrToG);
+    int32x4_t gHi = vmlal_n_s16(vmull_n_s16(vget_high_s16(cb), kCbToG), vget_high_s16(cr), kCrToG);
+    int32x4_t bLo = vmull_n_s16(vget_low_s16(cb), kCbToB);
+    int32x4_t bHi = vmull_n_s16(vget_high_s16(cb), kCbToB);
+    uint8x8x4_t rgba;
+    rgba.val[0] = vqmovun_s16(vaddq_s16(y, vcombine_s16(vrshrn_n_s32(rLo, 14), vrshrn_n_s32(rHi, 14))));
+    rgba.val[1] = vqmovun_s16(vaddq_s16(y, vcombine_s16(vrshrn_n_s32(gLo, 14), vrshrn_n_s32(gHi, 14))));
+    rgba.val[2] = vqmovun_s16(vaddq_s16(y, vcombine_s16(vrshrn_n_s32(bLo, 14), vrshrn_n_s32(bHi, 14))));
+    rgba.val[3] = vdup_n_u8(0xFF);
+    vst4_u8(dst + ii * 4, rgba);
+  };
+#endif
+  for (; ii < count; ++ii) {
+    int32_t y = yRow[ii];
+    int32_t cb = cbRow[ii] - 128;
+    int32_t cr = crRow[ii] - 128;
+    dst[ii * 4 + 0] = clampToUint8(y + ((kCrToR * cr + (1 << 13)) >> 14));
+    dst[ii * 4 + 1] = clampToUint8(y + ((kCbToG * cb + kCrToG * cr + (1 << 13)) >> 14));
+    dst[ii * 4 + 2] = clampToUint8(y + ((kCbToB * cb + (1 << 13)) >> 14));
+    dst[ii * 4 + 3] = 0xFF;
+  };
+}
+
+static void convertRGBRow(const uint8_t* rRow, const uint8_t* gRow, const uint8_t* bRow, uint8_t* dst, uint32_t count) {
+  for (uint32_t ii = 0; ii < count; ++ii) {
+    dst[ii * 4 + 0] = rRow[ii];
+    dst[ii * 4 + 1] = gRow[ii];
+    dst[ii * 4 + 2] = bRow[ii];
+    dst[ii * 4 + 3] = 0xFF;
+  };
+}
+
+static void convertGrayRow(const uint8_t* row, uint8_t* dst, uint32_t count) {
+  for (uint32_t ii = 0; ii < count; ++ii) {
+    dst[ii * 4 + 0] = dst[ii * 4 + 1] = dst[ii * 4 + 2] = row[ii];
+    dst[ii * 4 + 3] = 0xFF;
+  };
+}
+
+static bool readFrame(JPEGState& jpeg, const uint8_t* segment, uint32_t segmentLength, std::string& error) {
+  if (jpeg.frameDefined) {
+    error = "Multiple JPEG frames are not supported";
+    return false;
+  }
+  if (segmentLength < 6) {
+    error = "Invalid JPEG frame header";
+    return false;
+  }
+  if (segment[0] != 8) {
+    error = "Only 8-bit JPEG images are supported";
+    return false;
+  }
+  jpeg.height = readUint16BE(segment + 1);
+  jpeg.width = readUint16BE(segment + 3);
+  jpeg.componentCount = segment[5];
+  if (jpeg.width == 0 || jpeg.height == 0) {
+    error = "Invalid JPEG image dimensions";
+    return false;
+  }
+  if (static_cast<uint64_t>(jpeg.width) * jpeg.height * 4 > kMaxImageByteLength) {
+    error = "JPEG image dimensions are too large";
+    return false;
+  }
+  if (jpeg.componentCount != 1 && jpeg.componentCount != 3) {
+    error = "Only grayscale and 3-component JPEG images are supported";
+    return false;
+  }
+  if (segmentLength < 6 + jpeg.componentCount * 3) {
+    error = "Invalid JPEG frame header";
+    return false;
+  }
+  for (uint32_t ii = 0; ii < jpeg.componentCount; ++ii) {
+    Component& component = jpeg.components[ii];
+    const uint8_t* entry = segment + 6 + ii * 3;
+    component.id = entry[0];
+    component.h = entry[1] >> 4;
+    component.v = entry[1] & 15;
+    component.quantTable = entry[2];
+    if (component.h < 1 || component.h > 4 || component.v < 1 || component.v > 4 || component.quantTable > 3) {
+      error = "Invalid JPEG component";
+      return false;
+    }
+    jpeg.hMax = std::max(jpeg.hMax, component.h);
+    jpeg.vMax = std::max(jpeg.vMax, component.v);
+  };
+  // a single component is never interleaved, so its sampling factors don't matter
+  if (jpeg.componentCount == 1) {
+    jpeg.components[0].h = jpeg.components[0].v = 1;
+    jpeg.hMax = jpeg.vMax = 1;
+  }
+  jpeg.mcusPerLine = (jpeg.width + jpeg.hMax * 8 - 1) / (jpeg.hMax * 8);
+  jpeg.mcusPerColumn = (jpeg.height + jpeg.vMax * 8 - 1) / (jpeg.vMax * 8);
+  for (uint32_t ii = 0; ii < jpeg.componentCount; ++ii) {
+    Component& component = jpeg.components[ii];
+    component.sampleWidth = (jpeg.width * component.h + jpeg.hMax - 1) / jpeg.hMax;
+    component.sampleHeight = (jpeg.height * component.v + jpeg.vMax - 1) / jpeg.vMax;
+    component.blocksPerLine = jpeg.mcusPerLine * component.h;
+    component.blocksPerColumn = jpeg.mcusPerColumn * component.v;
+    component.coefficients.assign(static_cast<size_t>(component.blocksPerLine) * component.blocksPerColumn * 64, 0);
+  };
+  jpeg.frameDefined = true;
+  return true;
+}
+
+static bool readScan(JPEGState& jpeg, const uint8_t* src, size_t length, size_t& offset, const uint8_t* segment, uint32_t segmentLength, std::string& error) {
+  if (!jpeg.frameDefined) {
+    error = "JPEG scan before frame header";
+    return false;
+  }
+  uint32_t count = segmentLength > 0 ? segment[0] : 0;
+  if (count < 1 || count > jpeg.componentCount || segmentLength < 4 + count * 2) {
+    error = "Invalid JPEG scan header";
+    return false;
+  }
+  Component* components[3];
+  for (uint32_t ii = 0; ii < count; ++ii) {
+    const uint8_t* entry = segment + 1 + ii * 2;
+    components[ii] = nullptr;
+    for (uint32_t jj = 0; jj < jpeg.componentCount; ++jj) {
+      if (jpeg.components[jj].id == entry[0]) components[ii] = &jpeg.components[jj];
+    };
+    if (components[ii] == nullptr || (entry[1] >> 4) > 3 || (entry[1] & 15) > 3) {
+      error = "Invalid JPEG scan component";
+      return false;
+    }
+    components[ii]->dcTable = entry[1] >> 4;
+    components[ii]->acTable = entry[1] & 15;
+  };
+  const uint8_t* parameters = segment + 1 + count * 2;
+  uint32_t ss = parameters[0];
+  uint32_t se = parameters[1];
+  uint32_t ah = parameters[2] >> 4;
+  uint32_t al = parameters[2] & 15;
+
+  ScanMode mode = SCAN_SEQUENTIAL;
+  if (jpeg.progressive) {
+    bool valid = (
+      ss <= se && se <= 63 && al <= 13 &&
+      (ss == 0 ? se == 0 : count == 1)
+    );
+    if (!valid) {
+      error = "Invalid JPEG progressive scan";
+      return false;
+    }
+    if (ss == 0) mode = ah == 0 ? SCAN_DC_FIRST : SCAN_DC_REFINE;
+    else mode = ah == 0 ? SCAN_AC_FIRST : SCAN_AC_REFINE;
+  }
+  else {
+    ss = 0;
+    se = 63;
+    al = 0;
+  }
+
+  for (uint32_t ii = 0; ii < count; ++ii) {
+    Component& component = *components[ii];
+    bool needsDC = mode == SCAN_SEQUENTIAL || mode == SCAN_DC_FIRST;
+    bool needsAC = mode == SCAN_SEQUENTIAL || mode == SCAN_AC_FIRST || mode == SCAN_AC_REFINE;
+    if ((needsDC && !jpeg.dcTables[component.dcTable].defined) || (needsAC && !jpeg.acTables[component.acTable].defined)) {
+      error = "Missing JPEG huffman table";
+      return false;
+    }
+    if (!component.quantLatched) {
+      if (!jpeg.quantDefined[component.quantTable]) {
+        error = "Missing JPEG quantization table";
+        return false;
+      }
+      memcpy(component.quant, jpeg.quantTables[component.quantTable], sizeof(component.quant));
+      component.quantLatched = true;
+    }
+  };
+
+  if (!decodeScan(jpeg, src, length, offset, components, count, mode, ss, se, al)) {
+    error = "Corrupted JPEG image data";
+    return false;
+  }
+  return true;
+}
+
+static bool readTables(JPEGState& jpeg, uint8_t marker, const uint8_t* segment, uint32_t segmentLength, std::string& error) {
+  // DQT
+  if (marker == 0xDB) {
+    uint32_t offset = 0;
+    while (offset < segmentLength) {
+      uint32_t precision = segment[offset] >> 4;
+      uint32_t index = segment[offset] & 15;
+      uint32_t size = precision ? 128 : 64;
+      if (index > 3 || precision > 1 || offset + 1 + size > segmentLength) {
+        error = "Invalid JPEG quantization table";
+        return false;
+      }
+      const uint8_t* values = segment + offset + 1;
+      for (uint32_t ii = 0; ii < 64; ++ii) {
+        jpeg.quantTables[index][kZigZag[ii]] = precision ? readUint16BE(values + ii * 2) : values[ii];
+      };
+      jpeg.quantDefined[index] = true;
+      offset += 1 + size;
+    };
+    return true;
+  }
+  // DHT
+  if (marker == 0xC4) {
+    uint32_t offset = 0;
+    while (offset < segmentLength) {
+      if (offset + 17 > segmentLength) {
+        error = "Invalid JPEG huffman table";
+        return false;
+      }
+      uint32_t tableClass = segment[offset] >> 4;
+      uint32_t index = segment[offset] & 15;
+      const uint8_t* counts = segment + offset + 1;
+      uint32_t valueCount = 0;
+      for (uint32_t ii = 0; ii < 16; ++ii) valueCount += counts[ii];
+      if (tableClass > 1 || index > 3 || valueCount > 256 || offset + 17 + valueCount > segmentLength) {
+        error = "Invalid JPEG huffman table";
+        return false;
+      }
+      HuffmanTable& table = tableClass == 0 ? jpeg.dcTables[index] : jpeg.acTables[index];
+      if (!buildHuffmanTable(table, counts, segment + offset + 17, valueCount)) {
+        error = "Invalid JPEG huffman table";
+        return false;
+      }
+      offset += 17 + valueCount;
+    };
+    return true;
+  }
+  // DRI
+  if (marker == 0xDD) {
+    if (segmentLength < 2) {
+      error = "Invalid JPEG restart interval";
+      return false;
+    }
+    jpeg.restartInterval = readUint16BE(segment);
+    return true;
+  }
+  // APP14, tells if 3 components are RGB or YCbCr
+  if (marker == 0xEE) {
+    if (segmentLength >= 12 && memcmp(segment, "Adobe", 5) == 0) {
+      jpeg.adobe = true;
+      jpeg.adobeTransform = segment[11];
+    }
+    return true;
+  }
+  return true;
+}
+
+static void writeOutput(JPEGState& jpeg, std::vector<uint8_t>& data) {
+  for (uint32_t ii = 0; ii < jpeg.componentCount; ++ii) {
+    Component& component = jpeg.components[ii];
+    uint32_t stride = component.blocksPerLine * 8;
+    // components without any scan are all zero anyway
+    if (!component.quantLatched) memset(component.quant, 0, sizeof(component.quant));
+    component.samples.resize(static_cast<size_t>(stride) * component.blocksPerColumn * 8);
+    for (uint32_t by = 0; by < component.blocksPerColumn; ++by) {
+      for (uint32_t bx = 0; bx < component.blocksPerLine; ++bx) {
+        const int16_t* block = &component.coefficients[(static_cast<size_t>(by) * component.blocksPerLine + bx) * 64];
+        uint8_t* out = &component.samples[static_cast<size_t>(by) * 8 * stride + bx * 8];
+        idctBlock(block, component.quant, out, stride);
+      };
+    };
+    std::vector<int16_t>().swap(component.coefficients);
+  };
+
+  // plain RGB if the Adobe marker says so, or if the components are named like that
+  bool transform = true;
+  if (jpeg.adobe) {
+    transform = jpeg.adobeTransform != 0;
+  }
+  else if (jpeg.componentCount == 3) {
+    transform = !(jpeg.components[0].id == 'R' && jpeg.components[1].id == 'G' && jpeg.components[2].id == 'B');
+  }
+
+  data.resize(static_cast<size_t>(jpeg.width) * jpeg.height * 4);
+  std::vector<uint8_t> scratch(static_cast<size_t>(jpeg.width + 16) * jpeg.componentCount);
+  for (uint32_t yy = 0; yy < jpeg.height; ++yy) {
+    uint8_t* dst = &data[static_cast<size_t>(yy) * jpeg.width * 4];
+    if (jpeg.componentCount == 1) {
+      convertGrayRow(getComponentRow(jpeg, jpeg.components[0], yy, scratch.data()), dst, jpeg.width);
+      continue;
+    }
+    const uint8_t* rows[3];
+    for (uint32_t ii = 0; ii < 3; ++ii) {
+      rows[ii] = getComponentRow(jpeg, jpeg.components[ii], yy, &scratch[static_cast<size_t>(jpeg.width + 16) * ii]);
+    };
+    if (transform) convertYCbCrRow(rows[0], rows[1], rows[2], dst, jpeg.width);
+    else convertRGBRow(rows[0], rows[1], rows[2], dst, jpeg.width);
+  };
+}
+
+bool decodeJPEG(
+  const uint8_t* src,
+  size_t length,
+  uint32_t& width,
+  uint32_t& height,
+  std::vector<uint8_t>& data,
+  std::string& error
+) {
+  if (length < 4 || src[0] != 0xFF || src[1] != 0xD8) {
+    error = "Invalid JPEG signature";
+    return false;
+  }
+
+  JPEGState jpeg;
+  bool hasScan = false;
+  size_t offset = 2;
+  while (offset + 1 < length) {
+    // skip anything up to the next marker, including fill bytes
+    if (src[offset] != 0xFF || src[offset + 1] == 0x00 || src[offset + 1] == 0xFF || (src[offset + 1] >= 0xD0 && src[offset + 1] <= 0xD7)) {
+      offset++;
+      continue;
+    }
+    uint8_t marker = src[offset + 1];
+    offset += 2;
+    // EOI
+    if (marker == 0xD9) break;
+    if (offset + 2 > length) break;
+    uint32_t segmentLength = readUint16BE(src + offset);
+    if (segmentLength < 2 || offset + segmentLength > length) {
+      error = "Truncated JPEG segment";
+      return false;
+    }
+    const uint8_t* segment = src + offset + 2;
+    segmentLength -= 2;
+    offset += 2 + segmentLength;
+    switch (marker) {
+      // baseline and extended sequential
+      case 0xC0:
+      case 0xC1:
+        if (!readFrame(jpeg, segment, segmentLength, error)) return false;
+      break;
+      // progressive
+      case 0xC2:
+        jpeg.progressive = true;
+        if (!readFrame(jpeg, segment, segmentLength, error)) return false;
+      break;
+      case 0xC3:
+      case 0xC5: case 0xC6: case 0xC7:
+      case 0xC9: case 0xCA: case 0xCB:
+      case 0xCD: case 0xCE: case 0xCF:
+        error = "Lossless, hierarchical and arithmetic coded JPEG images are not supported";
+        return false;
+      // SOS, the entropy coded data follows the header
+      case 0xDA:
+        if (!readScan(jpeg, src, length, offset, segment, segmentLength, error)) return false;
+        hasScan = true;
+      break;
+      default:
+        if (!readTables(jpeg, marker, segment, segmentLength, error)) return false;
+      break;
+    };
+  };
+
+  if (!hasScan) {
+    error = "Invalid or incomplete JPEG image";
+    return false;
+  }
+
+  writeOutput(jpeg, data);
+  width = jpeg.width;
+  height = jpeg.height;
+  return true;
+}
@@ -0,0 +1,21 @@
+#ifndef __JPEG_DECODER_H__
+#define __JPEG_DECODER_H__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// decodes baseline and progressive huffman coded JPEGs with 1 (grayscale)
+// or 3 (YCbCr or RGB) components into RGBA8, arithmetic coding, 12-bit
+// samples and CMYK are rejected with an error
+bool decodeJPEG(
+  const uint8_t* src,
+  size_t length,
+  uint32_t& width,
+  uint32_t& height,
+  std::vector<uint8_t>& data,
+  std::string& error
+);
+
+#endif
@@ -0,0 +1,32 @@
+#include "PackedDescriptors.h"
+
+namespace PackedDescriptors {
+
+  uint8_t* base = nullptr;
+  size_t byteLength = 0;
+  Napi::ObjectReference handles;
+
+  static Napi::Reference<Napi::ArrayBuffer> scratch;
+
+  Napi::Value SetScratch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (!info[0].IsArrayBuffer() || !info[1].IsArray()) {
+      Napi::TypeError::New(env, "Expected 'ArrayBuffer' and 'Array'").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    // keep the buffer alive, its memory is referenced by 'base'
+    Napi::ArrayBuffer buffer = info[0].As<Napi::ArrayBuffer>();
+    scratch = Napi::Persistent(buffer);
+    scratch.SuppressDestruct();
+    base = reinterpret_cast<uint8_t*>(buffer.Data());
+    byteLength = buffer.ByteLength();
+
+    handles = Napi::Persistent(info[1].As<Napi::Object>());
+    handles.SuppressDestruct();
+
+    return env.Undefined();
+  };
+
+}
@@ -0,0 +1,80 @@
+#ifndef __PACKED_DESCRIPTORS_H__
+#define __PACKED_DESCRIPTORS_H__
+
+#define NAPI_EXPERIMENTAL
+#include <napi.h>
+
+#include <cstdint>
+#include <cstring>
+
+// descriptors which got packed by the generated js encoders ('memoryLayouts.js')
+// the encoders write the dawn structure into a shared scratch buffer, using the
+// memory layouts which the native module reported when bootstrapping, and pass
+// the byte offset of the structure instead of the descriptor object
+//
+// inside the scratch, pointers are stored as byte offsets relative to the scratch
+// (0 for null) and objects as index + 1 into the handles array (0 for null)
+// both get patched into real pointers before the structure is handed to dawn
+namespace PackedDescriptors {
+
+  extern uint8_t* base;
+  extern size_t byteLength;
+  extern Napi::ObjectReference handles;
+
+  // $setScratch(buffer, handles), called again whenever the js side grows the scratch
+  Napi::Value SetScratch(const Napi::CallbackInfo& info);
+
+  inline bool IsPacked(const Napi::Value& value) {
+    return value.IsNumber();
+  };
+
+  inline bool InBounds(uint64_t offset, uint64_t size) {
+    return offset <= byteLength && size <= byteLength - offset;
+  };
+
+  // returns the structure at the byte offset 'value', or null if it's out of bounds
+  template<typename T> T* Resolve(const Napi::Value& value) {
+    if (base == nullptr) return nullptr;
+    double offset = value.As<Napi::Number>().DoubleValue();
+    if (!(offset > 0) || offset != static_cast<double>(static_cast<uint64_t>(offset))) return nullptr;
+    if (!InBounds(static_cast<uint64_t>(offset), sizeof(T))) return nullptr;
+    if (static_cast<uint64_t>(offset) % alignof(T) != 0) return nullptr;
+    return reinterpret_cast<T*>(base + static_cast<uint64_t>(offset));
+  };
+
+  // turns the offset in 'slot' into a pointer to 'count' elements
+  template<typename T> bool PatchPointer(T*& slot, uint64_t count) {
+    uint64_t offset = reinterpret_cast<uintptr_t>(slot);
+    if (offset == 0) return true;
+    if (count > byteLength / (sizeof(T) > 0 ? sizeof(T) : 1)) return false;
+    if (!InBounds(offset, count * sizeof(T))) return false;
+    if (offset % alignof(T) != 0) return false;
+    slot = reinterpret_cast<T*>(base + offset);
+    return true;
+  };
+
+  // strings additionally have to be terminated inside the scratch
+  inline bool PatchString(const char*& slot) {
+    uint64_t offset = reinterpret_cast<uintptr_t>(slot);
+    if (offset == 0) return true;
+    if (offset >= byteLength) return false;
+    if (memchr(base + offset, 0, byteLength - offset) == nullptr) return false;
+    slot = reinterpret_cast<const char*>(base + offset);
+    return true;
+  };
+
+  // turns the handle index in 'slot' into the dawn object of the wrapped 'T'
+  template<typename T, typename Handle> bool PatchHandle(Handle& slot) {
+    uint64_t index = reinterpret_cast<uintptr_t>(slot);
+    if (index == 0) return true;
+    Napi::Object array = handles.Value();
+    if (array.IsEmpty()) return false;
+    Napi::Value value = array.Get(static_cast<uint32_t>(index - 1));
+    if (!value.IsObject() || !value.As<Napi::Object>().InstanceOf(T::constructor.Value())) return false;
+    slot = Napi::ObjectWrap<T>::Unwrap(value.As<Napi::Object>())->instance;
+    return true;
+  };
+
+}
+
+#endif
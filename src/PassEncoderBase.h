@@ -0,0 +1,277 @@
+#ifndef __GPU_PASS_ENCODER_BASE_H__
+#define __GPU_PASS_ENCODER_BASE_H__
+
+#include "Base.h"
+#include "Arguments.h"
+#include "EncoderState.h"
+#include "PassEncoderProcs.h"
+
+#include "GPUDevice.h"
+#include "GPUBuffer.h"
+#include "GPUBindGroup.h"
+#include "GPUQuerySet.h"
+
+#include "DescriptorDecoder.h"
+
+#include <vector>
+
+// no inheritance in NAPI, so the methods which all pass and bundle encoders share
+// (GPUProgrammablePassEncoder, GPURenderEncoderBase) are implemented once here
+// 'Procs' is the generated struct of the encoder's dawn procs, see 'PassEncoderProcs.h'
+// methods which the encoder doesn't have in the spec are never registered
+template<typename Derived, typename Procs> class PassEncoderBase : public Napi::ObjectWrap<Derived> {
+
+  public:
+
+    PassEncoderBase(const Napi::CallbackInfo &info) : Napi::ObjectWrap<Derived>(info) { };
+
+    // GPUProgrammablePassEncoder BEGIN
+    Napi::Value setBindGroup(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      uint32_t groupIndex = Arguments::Get<uint32_t>(info, 0);
+      WGPUBindGroup group = Arguments::Unwrap<GPUBindGroup>(info, 1)->instance;
+
+      std::vector<uint32_t> dynamicOffsets;
+      if (info[2].IsArray()) {
+        Napi::Array array = info[2].As<Napi::Array>();
+        dynamicOffsets.reserve(array.Length());
+        for (unsigned int ii = 0; ii < array.Length(); ++ii) {
+          dynamicOffsets.push_back(array.Get(ii).As<Napi::Number>().Uint32Value());
+        };
+      }
+
+      if (!this->state.setBindGroup(groupIndex, group, dynamicOffsets)) {
+        FrameStats::Increment(this->frameStats.counters().elidedBindGroupSets);
+        return env.Undefined();
+      }
+
+      Procs::SetBindGroup(this->instance, groupIndex, group, dynamicOffsets.size(), dynamicOffsets.data());
+      FrameStats::Increment(this->frameStats.counters().bindGroupSets);
+
+      return env.Undefined();
+    };
+
+    Napi::Value pushDebugGroup(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      std::string groupLabel = info[0].As<Napi::String>().Utf8Value();
+      Procs::PushDebugGroup(this->instance, groupLabel.c_str());
+      if (Tracer::IsEnabled()) {
+        Tracer::PushDebugGroup(reinterpret_cast<uint64_t>(this->traceId), groupLabel);
+      }
+
+      return env.Undefined();
+    };
+
+    Napi::Value popDebugGroup(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      Procs::PopDebugGroup(this->instance);
+      if (Tracer::IsEnabled()) {
+        Tracer::PopDebugGroup(reinterpret_cast<uint64_t>(this->traceId));
+      }
+
+      return env.Undefined();
+    };
+
+    Napi::Value insertDebugMarker(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      std::string markerLabel = info[0].As<Napi::String>().Utf8Value();
+      Procs::InsertDebugMarker(this->instance, markerLabel.c_str());
+
+      return env.Undefined();
+    };
+
+    Napi::Value writeTimestamp(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      GPUQuerySet* querySet = Arguments::Unwrap<GPUQuerySet>(info, 0);
+      uint32_t queryIndex = Arguments::Get<uint32_t>(info, 1);
+
+      if (!querySet->writeTimestamp(queryIndex)) {
+        GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+        device->throwCallbackError(
+          Napi::String::New(env, "Range"),
+          Napi::String::New(env, "Query index is out of range")
+        );
+      }
+
+      return env.Undefined();
+    };
+    // GPUProgrammablePassEncoder END
+
+    Napi::Value setPipeline(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      auto pipeline = Arguments::Unwrap<typename Procs::Pipeline>(info, 0)->instance;
+
+      if (!this->state.setPipeline(pipeline)) {
+        FrameStats::Increment(this->frameStats.counters().elidedPipelineSwitches);
+        return env.Undefined();
+      }
+
+      Procs::SetPipeline(this->instance, pipeline);
+      FrameStats::Increment(this->frameStats.counters().pipelineSwitches);
+
+      return env.Undefined();
+    };
+
+    // GPURenderEncoderBase BEGIN
+    Napi::Value setIndexBuffer(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      WGPUBuffer buffer = Arguments::Unwrap<GPUBuffer>(info, 0)->instance;
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      if (!this->getUint64Argument(info, 1, offset, "offset")) return env.Undefined();
+      if (!this->getUint64Argument(info, 2, size, "size")) return env.Undefined();
+
+      if (!this->state.setIndexBuffer(buffer, offset, size)) {
+        FrameStats::Increment(this->frameStats.counters().elidedIndexBufferSets);
+        return env.Undefined();
+      }
+
+      Procs::SetIndexBuffer(this->instance, buffer, offset, size);
+
+      return env.Undefined();
+    };
+
+    Napi::Value setVertexBuffer(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      uint32_t startSlot = Arguments::Get<uint32_t>(info, 0);
+      WGPUBuffer buffer = Arguments::Unwrap<GPUBuffer>(info, 1)->instance;
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      if (!this->getUint64Argument(info, 2, offset, "offset")) return env.Undefined();
+      if (!this->getUint64Argument(info, 3, size, "size")) return env.Undefined();
+
+      if (!this->state.setVertexBuffer(startSlot, buffer, offset, size)) {
+        FrameStats::Increment(this->frameStats.counters().elidedVertexBufferSets);
+        return env.Undefined();
+      }
+
+      Procs::SetVertexBuffer(this->instance, startSlot, buffer, offset, size);
+
+      return env.Undefined();
+    };
+
+    Napi::Value draw(const Napi::CallbackInfo &info) {
+      Procs::Draw(this->instance, info);
+      FrameStats::Increment(this->frameStats.counters().draws);
+      return info.Env().Undefined();
+    };
+
+    Napi::Value drawIndexed(const Napi::CallbackInfo &info) {
+      Procs::DrawIndexed(this->instance, info);
+      FrameStats::Increment(this->frameStats.counters().draws);
+      return info.Env().Undefined();
+    };
+
+    Napi::Value drawIndirect(const Napi::CallbackInfo &info) {
+      WGPUBuffer indirectBuffer = Arguments::Unwrap<GPUBuffer>(info, 0)->instance;
+      uint64_t indirectOffset = 0;
+      if (!this->getDevice()->decodeUint64(info[1], indirectOffset, "indirectOffset")) return info.Env().Undefined();
+      Procs::DrawIndirect(this->instance, indirectBuffer, indirectOffset);
+      FrameStats::Increment(this->frameStats.counters().draws);
+      return info.Env().Undefined();
+    };
+
+    Napi::Value drawIndexedIndirect(const Napi::CallbackInfo &info) {
+      WGPUBuffer indirectBuffer = Arguments::Unwrap<GPUBuffer>(info, 0)->instance;
+      uint64_t indirectOffset = 0;
+      if (!this->getDevice()->decodeUint64(info[1], indirectOffset, "indirectOffset")) return info.Env().Undefined();
+      Procs::DrawIndexedIndirect(this->instance, indirectBuffer, indirectOffset);
+      FrameStats::Increment(this->frameStats.counters().draws);
+      return info.Env().Undefined();
+    };
+    // GPURenderEncoderBase END
+
+    // GPURenderPassEncoder BEGIN
+    Napi::Value setViewport(const Napi::CallbackInfo &info) {
+      Procs::SetViewport(this->instance, info);
+      return info.Env().Undefined();
+    };
+
+    Napi::Value setScissorRect(const Napi::CallbackInfo &info) {
+      Procs::SetScissorRect(this->instance, info);
+      return info.Env().Undefined();
+    };
+
+    Napi::Value setStencilReference(const Napi::CallbackInfo &info) {
+      Procs::SetStencilReference(this->instance, info);
+      return info.Env().Undefined();
+    };
+
+    Napi::Value setBlendColor(const Napi::CallbackInfo &info) {
+      Napi::Env env = info.Env();
+
+      GPUDevice* device = Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+      auto color = DescriptorDecoder::GPUColor(device, info[0].As<Napi::Value>());
+      Procs::SetBlendColor(this->instance, &color);
+
+      return env.Undefined();
+    };
+    // GPURenderPassEncoder END
+
+    // GPUComputePassEncoder BEGIN
+    Napi::Value dispatch(const Napi::CallbackInfo &info) {
+      Procs::Dispatch(this->instance, info);
+      FrameStats::Increment(this->frameStats.counters().dispatches);
+      return info.Env().Undefined();
+    };
+
+    Napi::Value dispatchIndirect(const Napi::CallbackInfo &info) {
+      WGPUBuffer indirectBuffer = Arguments::Unwrap<GPUBuffer>(info, 0)->instance;
+      uint64_t indirectOffset = 0;
+      if (!this->getDevice()->decodeUint64(info[1], indirectOffset, "indirectOffset")) return info.Env().Undefined();
+      Procs::DispatchIndirect(this->instance, indirectBuffer, indirectOffset);
+      FrameStats::Increment(this->frameStats.counters().dispatches);
+      return info.Env().Undefined();
+    };
+    // GPUComputePassEncoder END
+
+    // GPURayTracingPassEncoder BEGIN
+    Napi::Value traceRays(const Napi::CallbackInfo &info) {
+      Procs::TraceRays(this->instance, info);
+      return info.Env().Undefined();
+    };
+    // GPURayTracingPassEncoder END
+
+    Napi::Value endPass(const Napi::CallbackInfo &info) {
+      Procs::EndPass(this->instance);
+      Tracer::AsyncEnd("gpu", this->traceName, this->traceId);
+      return info.Env().Undefined();
+    };
+
+    Napi::ObjectReference device;
+    Napi::ObjectReference commandEncoder;
+
+    typename Procs::Instance instance;
+
+    FrameStats::Tracker frameStats;
+
+  protected:
+
+    EncoderState state;
+
+    GPUDevice* getDevice() {
+      return Napi::ObjectWrap<GPUDevice>::Unwrap(this->device.Value());
+    };
+
+    // optional 64-bit arguments keep the value of 'out' when undefined
+    bool getUint64Argument(const Napi::CallbackInfo& info, size_t index, uint64_t& out, const char* name) {
+      if (info[index].IsUndefined()) return true;
+      return this->getDevice()->decodeUint64(info[index], out, name);
+    };
+
+    // debug groups and the pass slice are recorded on the command encoder
+    // the pass belongs to, or on the encoder itself for bundles
+    const void* traceId = nullptr;
+    const char* traceName = nullptr;
+
+};
+
+#endif
@@ -0,0 +1,2 @@
+// creates the precompiled header on windows
+#include "Pch.h"
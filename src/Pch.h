@@ -0,0 +1,12 @@
+#ifndef __PCH_H__
+#define __PCH_H__
+
+// the headers which almost every translation unit includes, precompiled
+// where gyp supports it (msvs and xcode), see 'binding-gyp.njk'
+#include "Base.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#endif
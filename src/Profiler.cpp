@@ -0,0 +1,59 @@
+#include "Profiler.h"
+
+#include <memory>
+#include <vector>
+#include <cstdlib>
+
+namespace Profiler {
+
+  // profiling can be enabled at startup with WEBGPU_PROFILE=1
+  bool enabled = std::getenv("WEBGPU_PROFILE") != nullptr;
+  Entry* current = nullptr;
+  uint32_t decodeDepth = 0;
+
+  static std::vector<std::unique_ptr<Entry>> entries;
+
+  Entry* CreateEntry(const char* className, const char* methodName) {
+    Entry* entry = new Entry();
+    entry->name = std::string(className) + "." + methodName;
+    entries.push_back(std::unique_ptr<Entry>(entry));
+    return entry;
+  };
+
+  Napi::Value GetProfile(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Array out = Napi::Array::New(env);
+    uint32_t index = 0;
+    for (auto& entry : entries) {
+      if (entry->calls == 0) continue;
+      Napi::Object item = Napi::Object::New(env);
+      item.Set("name", Napi::String::New(env, entry->name));
+      item.Set("calls", Napi::Number::New(env, static_cast<double>(entry->calls)));
+      // in milliseconds
+      item.Set("nativeTime", Napi::Number::New(env, entry->nativeTime * 1e-6));
+      item.Set("decodeTime", Napi::Number::New(env, entry->decodeTime * 1e-6));
+      item.Set("dawnTime", Napi::Number::New(env, (entry->nativeTime - entry->decodeTime) * 1e-6));
+      out.Set(index++, item);
+    };
+    // optionally reset, e.g. once per frame
+    if (info[0].IsBoolean() && info[0].As<Napi::Boolean>().Value()) ResetProfile(info);
+    return out;
+  };
+
+  Napi::Value ResetProfile(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    for (auto& entry : entries) {
+      entry->calls = 0;
+      entry->nativeTime = 0;
+      entry->decodeTime = 0;
+    };
+    return env.Undefined();
+  };
+
+  Napi::Value EnableProfiling(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    enabled = info[0].IsBoolean() ? info[0].As<Napi::Boolean>().Value() : true;
+    return env.Undefined();
+  };
+
+}
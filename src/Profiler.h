@@ -0,0 +1,125 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#define NAPI_EXPERIMENTAL
+#include <napi.h>
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+
+#include "FrameStats.h"
+#include "Capture.h"
+
+namespace Profiler {
+
+  struct Entry {
+    std::string name;
+    uint64_t calls = 0;
+    // inclusive native time of all calls in ns
+    uint64_t nativeTime = 0;
+    // time of the above spent in descriptor decoding
+    uint64_t decodeTime = 0;
+  };
+
+  extern bool enabled;
+  // the method which is currently executed, decoding time gets attributed to it
+  extern Entry* current;
+  extern uint32_t decodeDepth;
+
+  Entry* CreateEntry(const char* className, const char* methodName);
+
+  Napi::Value GetProfile(const Napi::CallbackInfo& info);
+  Napi::Value ResetProfile(const Napi::CallbackInfo& info);
+  Napi::Value EnableProfiling(const Napi::CallbackInfo& info);
+
+  inline uint64_t Now() {
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+      ).count()
+    );
+  };
+
+  // measures the time of a descriptor decode, nested decodes are only counted once
+  // the time always goes into the frame stats of the device, and into the current method when profiling
+  class ScopedDecode {
+    public:
+      ScopedDecode(FrameStats::Counters& counters) : counters(counters) {
+        if (decodeDepth++ == 0) start = Now();
+      };
+      ~ScopedDecode() {
+        if (--decodeDepth != 0) return;
+        uint64_t time = Now() - start;
+        FrameStats::Increment(counters.decodeTime, time);
+        if (enabled && current != nullptr) current->decodeTime += time;
+      };
+    private:
+      FrameStats::Counters& counters;
+      uint64_t start = 0;
+  };
+
+  // measures a method call, restores the outer call (if any) when done
+  class ScopedCall {
+    public:
+      ScopedCall(Entry* entry) : entry(entry), previous(current), previousDecodeDepth(decodeDepth) {
+        current = entry;
+        decodeDepth = 0;
+        start = Now();
+      };
+      ~ScopedCall() {
+        entry->nativeTime += Now() - start;
+        entry->calls++;
+        current = previous;
+        decodeDepth = previousDecodeDepth;
+      };
+    private:
+      Entry* entry;
+      Entry* previous;
+      uint32_t previousDecodeDepth;
+      uint64_t start = 0;
+  };
+
+  template<typename T> struct MethodData {
+    Napi::Value (T::*method)(const Napi::CallbackInfo&);
+    Entry* entry;
+  };
+
+  template<typename T> Napi::Value InvokeMethod(T* self, MethodData<T>* data, const Napi::CallbackInfo& info) {
+    if (!enabled) return (self->*(data->method))(info);
+    ScopedCall call(data->entry);
+    return (self->*(data->method))(info);
+  };
+
+  template<typename T> Napi::Value CallMethod(const Napi::CallbackInfo& info) {
+    MethodData<T>* data = reinterpret_cast<MethodData<T>*>(info.Data());
+    T* self = Napi::ObjectWrap<T>::Unwrap(info.This().As<Napi::Object>());
+    if (!Capture::IsEnabled()) return InvokeMethod(self, data, info);
+    Capture::ScopedCall capture(info, data->entry->name);
+    Napi::Value result = InvokeMethod(self, data, info);
+    capture.SetResult(result);
+    return result;
+  };
+
+}
+
+// drop-in replacement for 'InstanceMethod', records the call count and
+// native time of the method when profiling is enabled, and the call itself when capturing
+template<typename T> Napi::ClassPropertyDescriptor<T> ProfiledMethod(
+  Napi::Env env,
+  const char* className,
+  const char* name,
+  Napi::Value (T::*method)(const Napi::CallbackInfo&),
+  napi_property_attributes attributes = napi_default
+) {
+  // lives as long as the class itself
+  Profiler::MethodData<T>* data = new Profiler::MethodData<T>();
+  data->method = method;
+  data->entry = Profiler::CreateEntry(className, name);
+  Napi::Function func = Napi::Function::New(env, &Profiler::CallMethod<T>, name, data);
+  // writable and configurable like WebIDL operations, index.js wraps some of them
+  attributes = static_cast<napi_property_attributes>(attributes | napi_writable | napi_configurable);
+  return Napi::ObjectWrap<T>::InstanceValue(name, func, attributes);
+};
+
+#endif
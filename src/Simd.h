@@ -0,0 +1,13 @@
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+// explicit simd paths of the image kernels, other targets use the scalar loops
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SIMD_SSE2
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #define SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+#include "Tracer.h"
+
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <unordered_map>
+
+namespace Tracer {
+
+  struct Event {
+    // index + 1 of the event once it is completely written, 0 while writing
+    std::atomic<uint64_t> sequence{0};
+    uint64_t timestamp = 0;
+    uint64_t id = 0;
+    uint32_t tid = 0;
+    char phase = 0;
+    const char* category = nullptr;
+    char name[64];
+  };
+
+  static const uint32_t kDefaultCapacity = 1 << 16;
+
+  std::atomic<bool> enabled{false};
+
+  static std::unique_ptr<Event[]> events;
+  static uint64_t capacity = 0;
+  static std::atomic<uint64_t> head{0};
+
+  // label stacks of open debug groups, by encoder id
+  static std::unordered_map<uint64_t, std::vector<std::string>> debugGroups;
+
+  static uint64_t GetTimestamp() {
+    // microseconds on the monotonic clock, same as node's --cpu-prof
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+      ).count()
+    );
+  };
+
+  static uint32_t GetThreadId() {
+    static thread_local uint32_t tid = static_cast<uint32_t>(
+      std::hash<std::thread::id>()(std::this_thread::get_id())
+    );
+    return tid;
+  };
+
+  void Record(char phase, const char* category, const char* name, uint64_t id) {
+    if (!IsEnabled()) return;
+    uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+    Event& event = events[index & (capacity - 1)];
+    event.sequence.store(0, std::memory_order_release);
+    event.timestamp = GetTimestamp();
+    event.id = id;
+    event.tid = GetThreadId();
+    event.phase = phase;
+    event.category = category;
+    strncpy(event.name, name, sizeof(event.name) - 1);
+    event.name[sizeof(event.name) - 1] = '\0';
+    event.sequence.store(index + 1, std::memory_order_release);
+  };
+
+  void PushDebugGroup(uint64_t id, const std::string& label) {
+    if (!IsEnabled()) return;
+    debugGroups[id].push_back(label);
+    Record('b', "gpu", label.c_str(), id);
+  };
+
+  void PopDebugGroup(uint64_t id) {
+    if (!IsEnabled()) return;
+    auto it = debugGroups.find(id);
+    // the group was pushed before tracing got started
+    if (it == debugGroups.end() || it->second.empty()) return;
+    Record('e', "gpu", it->second.back().c_str(), id);
+    it->second.pop_back();
+    if (it->second.empty()) debugGroups.erase(it);
+  };
+
+  static void WriteEscapedString(std::string& out, const char* str) {
+    out += '"';
+    for (const char* c = str; *c != '\0'; ++c) {
+      switch (*c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        default: {
+          if (static_cast<unsigned char>(*c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+            out += escaped;
+          } else {
+            out += *c;
+          }
+        } break;
+      };
+    };
+    out += '"';
+  };
+
+  Napi::Value StartTracing(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (IsEnabled()) return env.Undefined();
+    // capacity is rounded up to a power of two
+    uint64_t requestedCapacity = info[0].IsNumber() ? info[0].As<Napi::Number>().Uint32Value() : kDefaultCapacity;
+    uint64_t nextCapacity = 1;
+    while (nextCapacity < requestedCapacity) nextCapacity <<= 1;
+    if (nextCapacity != capacity) {
+      events.reset(new Event[nextCapacity]);
+      capacity = nextCapacity;
+    }
+    for (uint64_t ii = 0; ii < capacity; ++ii) events[ii].sequence.store(0, std::memory_order_relaxed);
+    head.store(0, std::memory_order_relaxed);
+    debugGroups.clear();
+    enabled.store(true, std::memory_order_release);
+    return env.Undefined();
+  };
+
+  Napi::Value StopTracing(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    enabled.store(false, std::memory_order_release);
+    debugGroups.clear();
+    return env.Undefined();
+  };
+
+  Napi::Value GetTrace(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    uint32_t pid = env.Global().Get("process").As<Napi::Object>().Get("pid").As<Napi::Number>().Uint32Value();
+    std::string out = "{\"traceEvents\":[";
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity ? end - capacity : 0;
+    bool first = true;
+    for (uint64_t index = begin; index < end; ++index) {
+      Event& slot = events[index & (capacity - 1)];
+      // skip events which are still being written or already got overwritten
+      if (slot.sequence.load(std::memory_order_acquire) != index + 1) continue;
+      char phase = slot.phase;
+      uint64_t timestamp = slot.timestamp;
+      uint64_t id = slot.id;
+      uint32_t tid = slot.tid;
+      const char* category = slot.category;
+      char name[sizeof(slot.name)];
+      memcpy(name, slot.name, sizeof(name));
+      if (slot.sequence.load(std::memory_order_acquire) != index + 1) continue;
+      char buffer[128];
+      if (!first) out += ",";
+      first = false;
+      out += "{\"name\":";
+      WriteEscapedString(out, name);
+      out += ",\"cat\":";
+      WriteEscapedString(out, category);
+      snprintf(
+        buffer, sizeof(buffer),
+        ",\"ph\":\"%c\",\"ts\":%llu,\"pid\":%u,\"tid\":%u",
+        phase, static_cast<unsigned long long>(timestamp), pid, tid
+      );
+      out += buffer;
+      if (phase == 'b' || phase == 'e') {
+        snprintf(buffer, sizeof(buffer), ",\"id\":\"0x%llx\"", static_cast<unsigned long long>(id));
+        out += buffer;
+      }
+      out += "}";
+    };
+    out += "],\"displayTimeUnit\":\"ms\"}";
+    return Napi::String::New(env, out);
+  };
+
+}
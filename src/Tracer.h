@@ -0,0 +1,58 @@
+#ifndef __TRACER_H__
+#define __TRACER_H__
+
+#define NAPI_EXPERIMENTAL
+#include <napi.h>
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+// records timestamped events into a lock-free ring buffer,
+// which can be exported in chrome's trace_event format
+namespace Tracer {
+
+  extern std::atomic<bool> enabled;
+
+  // phases as defined by the trace_event format
+  // 'B'/'E' are synchronous slices, 'b'/'e' nestable async slices grouped by id
+  void Record(char phase, const char* category, const char* name, uint64_t id = 0);
+
+  // debug groups become nested async slices of the encoder with the given id
+  void PushDebugGroup(uint64_t id, const std::string& label);
+  void PopDebugGroup(uint64_t id);
+
+  Napi::Value StartTracing(const Napi::CallbackInfo& info);
+  Napi::Value StopTracing(const Napi::CallbackInfo& info);
+  Napi::Value GetTrace(const Napi::CallbackInfo& info);
+
+  inline bool IsEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+  };
+
+  inline void AsyncBegin(const char* category, const char* name, const void* id) {
+    if (IsEnabled()) Record('b', category, name, reinterpret_cast<uint64_t>(id));
+  };
+
+  inline void AsyncEnd(const char* category, const char* name, const void* id) {
+    if (IsEnabled()) Record('e', category, name, reinterpret_cast<uint64_t>(id));
+  };
+
+  class ScopedEvent {
+    public:
+      ScopedEvent(const char* category, const char* name) : category(category), name(name) {
+        active = IsEnabled();
+        if (active) Record('B', category, name);
+      };
+      ~ScopedEvent() {
+        if (active) Record('E', category, name);
+      };
+    private:
+      const char* category;
+      const char* name;
+      bool active;
+  };
+
+}
+
+#endif
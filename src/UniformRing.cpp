@@ -0,0 +1,113 @@
+#include "UniformRing.h"
+#include "GPUDevice.h"
+#include "GPUBuffer.h"
+
+UniformRing::~UniformRing() {
+  this->buffer.Reset();
+  this->memory.Reset();
+  if (this->fence != nullptr) wgpuFenceRelease(this->fence);
+}
+
+void UniformRing::create(Napi::Object deviceObject) {
+  Napi::Env env = deviceObject.Env();
+
+  Napi::Object descriptor = Napi::Object::New(env);
+  descriptor.Set("size", Napi::Number::New(env, static_cast<double>(this->size)));
+  descriptor.Set("usage", Napi::Number::New(env, WGPUBufferUsage_Uniform | WGPUBufferUsage_CopyDst));
+  Napi::Object buffer = GPUBuffer::constructor.New({ deviceObject, descriptor });
+  this->buffer.Reset(buffer, 1);
+  GPUBuffer* uwBuffer = Napi::ObjectWrap<GPUBuffer>::Unwrap(buffer);
+  this->bufferInstance = uwBuffer->instance;
+  this->counters = &uwBuffer->frameStats.counters();
+
+  Napi::ArrayBuffer memory = Napi::ArrayBuffer::New(env, this->size);
+  this->memory.Reset(memory, 1);
+  this->memoryData = reinterpret_cast<uint8_t*>(memory.Data());
+}
+
+void UniformRing::retireFrames() {
+  while (!this->frames.empty()) {
+    Frame& frame = this->frames.front();
+    if (wgpuFenceGetCompletedValue(this->fence) < frame.fenceValue) break;
+    this->tail = frame.head;
+    this->frames.pop_front();
+  };
+}
+
+Napi::Value UniformRing::allocate(GPUDevice* device, Napi::Object deviceObject, uint64_t size) {
+  Napi::Env env = deviceObject.Env();
+
+  if (this->buffer.IsEmpty()) this->create(deviceObject);
+
+  // checked before aligning, which could overflow otherwise
+  // the ring size itself is aligned, so the aligned size fits too
+  if (size > this->size) {
+    device->throwCallbackError(
+      Napi::String::New(env, "Range"),
+      Napi::String::New(env, "Allocation size exceeds the uniform ring size of " + std::to_string(this->size) + " bytes")
+    );
+    return env.Undefined();
+  }
+  uint64_t alignedSize = alignTo(std::max(size, static_cast<uint64_t>(4)), kAlignment);
+
+  // slices never wrap around, the remainder at the end of the ring is skipped
+  uint64_t offset = this->head % this->size;
+  uint64_t padding = offset + alignedSize > this->size ? this->size - offset : 0;
+  uint64_t required = padding + alignedSize;
+
+  // wait for the GPU to finish older frames
+  if (this->head - this->tail + required > this->size) {
+    this->retireFrames();
+    while (this->head - this->tail + required > this->size && !this->frames.empty()) {
+      wgpuDeviceTick(device->instance);
+      this->retireFrames();
+    };
+    if (this->head - this->tail + required > this->size) {
+      device->throwCallbackError(
+        Napi::String::New(env, "Range"),
+        Napi::String::New(env, "Uniform ring is exhausted, the current frame exceeds its size of " + std::to_string(this->size) + " bytes")
+      );
+      return env.Undefined();
+    }
+  }
+
+  this->head += padding;
+  offset = this->head % this->size;
+  this->head += alignedSize;
+
+  Napi::Object out = Napi::Object::New(env);
+  out.Set("buffer", this->buffer.Value());
+  out.Set("offset", Napi::Number::New(env, static_cast<double>(offset)));
+  out.Set("data", Napi::Float32Array::New(env, alignTo(size, 4) / 4, this->memory.Value().As<Napi::ArrayBuffer>(), offset));
+  return out;
+}
+
+void UniformRing::flush() {
+  uint64_t length = this->head - this->uploaded;
+  if (length == 0) return;
+  uint64_t offset = this->uploaded % this->size;
+  uint64_t first = std::min(length, this->size - offset);
+  wgpuBufferSetSubData(this->bufferInstance, offset, first, this->memoryData + offset);
+  if (length > first) {
+    wgpuBufferSetSubData(this->bufferInstance, 0, length - first, this->memoryData);
+  }
+  FrameStats::Increment(this->counters->bufferBytesUploaded, length);
+  this->uploaded = this->head;
+}
+
+void UniformRing::endFrame(WGPUQueue queue) {
+  if (this->buffer.IsEmpty()) return;
+  this->flush();
+  this->retireFrames();
+  // nothing got allocated during this frame
+  if (this->head == (this->frames.empty() ? this->tail : this->frames.back().head)) return;
+  if (this->fence == nullptr) {
+    WGPUFenceDescriptor descriptor;
+    descriptor.nextInChain = nullptr;
+    descriptor.label = nullptr;
+    descriptor.initialValue = 0;
+    this->fence = wgpuQueueCreateFence(queue, &descriptor);
+  }
+  wgpuQueueSignal(queue, this->fence, ++this->fenceValue);
+  this->frames.push_back({ this->fenceValue, this->head });
+}
@@ -0,0 +1,61 @@
+#ifndef __GPU_UNIFORM_RING_H__
+#define __GPU_UNIFORM_RING_H__
+
+#include "Base.h"
+
+#include <deque>
+
+class GPUDevice;
+
+// hands out 256-byte aligned slices of a single uniform buffer, which can be
+// bound once and then be addressed with dynamic offsets
+// slices are written into a CPU-side shadow of the buffer and the written
+// range gets uploaded right before the next submit of the device's queue
+// each frame signals a fence, a slice is only reused after the GPU finished its frame
+class UniformRing {
+
+  public:
+
+    static const uint64_t kDefaultSize = 4 << 20;
+    static const uint64_t kAlignment = 256;
+
+    ~UniformRing();
+
+    // returns { buffer, offset, data }, where data is a Float32Array view of the slice
+    Napi::Value allocate(GPUDevice* device, Napi::Object deviceObject, uint64_t size);
+
+    // uploads the slices allocated since the last flush
+    void flush();
+
+    // ends the current frame, its slices get released once the GPU reached the fence
+    void endFrame(WGPUQueue queue);
+
+    uint64_t size = kDefaultSize;
+
+  private:
+    Napi::ObjectReference buffer;
+    Napi::ObjectReference memory;
+    WGPUBuffer bufferInstance = nullptr;
+    // frame stats of the device, through the buffer
+    FrameStats::Counters* counters = nullptr;
+    uint8_t* memoryData = nullptr;
+
+    // monotonic byte positions, the ring offset is the position modulo the size
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    uint64_t uploaded = 0;
+
+    struct Frame {
+      uint64_t fenceValue;
+      uint64_t head;
+    };
+    std::deque<Frame> frames;
+    WGPUFence fence = nullptr;
+    uint64_t fenceValue = 0;
+
+    void create(Napi::Object deviceObject);
+    void retireFrames();
+
+};
+
+#endif
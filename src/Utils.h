@@ -4,6 +4,8 @@
 #define NAPI_EXPERIMENTAL
 #include <napi.h>
 
+#include <cmath>
+
 inline char* getNAPIStringCopy(const Napi::Value& value) {
   std::string utf8 = value.ToString().Utf8Value();
   int len = utf8.length() + 1; // +1 NULL
@@ -33,4 +35,36 @@ template<typename T> inline T* getTypedArrayData(const Napi::Value& value, size_
   return data;
 };
 
+// reads a 64-bit offset or size, passed either as BigInt or as Number
+// returns false for lossy BigInts and for Numbers which aren't a safe non-negative integer
+inline bool getUint64Value(const Napi::Value& value, uint64_t& out) {
+  out = 0;
+  if (value.IsBigInt()) {
+    bool lossless = false;
+    uint64_t bigint = value.As<Napi::BigInt>().Uint64Value(&lossless);
+    if (!lossless) return false;
+    out = bigint;
+    return true;
+  }
+  if (!value.IsNumber()) return false;
+  double number = value.As<Napi::Number>().DoubleValue();
+  // also rejects NaN
+  if (!(number >= 0.0 && number <= 9007199254740991.0) || number != std::floor(number)) return false;
+  out = static_cast<uint64_t>(number);
+  return true;
+};
+
+// returns a Number when the value is safely representable, otherwise a BigInt
+inline Napi::Value createUint64Value(Napi::Env env, uint64_t value) {
+  if (value <= 9007199254740991ull) return Napi::Number::New(env, static_cast<double>(value));
+  return Napi::BigInt::New(env, value);
+};
+
+// required alignment of 'bytesPerRow' in buffer <-> texture copies
+static const uint32_t kCopyRowPitchAlignment = 256;
+
+inline uint64_t alignTo(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+};
+
 #endif
@@ -1,8 +1,11 @@
 #include "WebGPUWindow.h"
 #include "GPUCanvasContext.h"
+#include "GPUDevice.h"
 
 Napi::FunctionReference WebGPUWindow::constructor;
 
+std::vector<WebGPUWindow*> WebGPUWindow::windows;
+
 WebGPUWindow::WebGPUWindow(const Napi::CallbackInfo& info) : Napi::ObjectWrap<WebGPUWindow>(info), env_(info.Env()) {
   Napi::Env env = env_;
   if (info.IsConstructCall()) {
@@ -25,6 +28,17 @@ WebGPUWindow::WebGPUWindow(const Napi::CallbackInfo& info) : Napi::ObjectWrap<We
       } else {
         glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
       }
+      // events are queued as records, see EventQueue.h
+      if (obj.Has("eventQueue")) {
+        Napi::Value argEventQueue = obj.Get("eventQueue");
+        uint32_t capacity = 0;
+        if (argEventQueue.IsNumber()) capacity = argEventQueue.As<Napi::Number>().Uint32Value();
+        else if (argEventQueue.IsBoolean() && argEventQueue.As<Napi::Boolean>().Value()) capacity = 1024;
+        if (capacity > 0) this->eventQueue = new EventQueue(env, capacity);
+      }
+      if (obj.Has("coalesceEvents") && obj.Get("coalesceEvents").IsBoolean()) {
+        this->coalesceEvents = obj.Get("coalesceEvents").As<Napi::Boolean>().Value();
+      }
       #ifdef __APPLE__
       glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GLFW_TRUE);
       #endif
@@ -44,6 +58,7 @@ WebGPUWindow::WebGPUWindow(const Napi::CallbackInfo& info) : Napi::ObjectWrap<We
       glfwSetMouseButtonCallback(window, WebGPUWindow::onWindowMouseButton);
       // file drop
       glfwSetDropCallback(window, WebGPUWindow::onWindowDrop);
+      WebGPUWindow::windows.push_back(this);
     } else {
       Napi::Error::New(env, "Argument 1 must be of type 'Object'").ThrowAsJavaScriptException();
     }
@@ -63,35 +78,101 @@ WebGPUWindow::~WebGPUWindow() {
   this->onmousedown.Reset();
   this->onmouseup.Reset();
   this->ondrop.Reset();
+  delete this->eventQueue;
+  delete this->binding;
+  auto it = std::find(WebGPUWindow::windows.begin(), WebGPUWindow::windows.end(), this);
+  if (it != WebGPUWindow::windows.end()) WebGPUWindow::windows.erase(it);
+}
+
+BackendBinding* WebGPUWindow::getBinding(GPUDevice* device) {
+  if (this->binding != nullptr && this->bindingDevice == device->instance) return this->binding;
+  delete this->binding;
+  this->binding = CreateBinding(device->_adapter.GetBackendType(), this->instance, device->instance);
+  this->bindingDevice = device->instance;
+  return this->binding;
+}
+
+void WebGPUWindow::releaseBinding(WGPUDevice device) {
+  if (this->bindingDevice != device) return;
+  delete this->binding;
+  this->binding = nullptr;
+  this->bindingDevice = nullptr;
+}
+
+void WebGPUWindow::PollEvents() {
+  glfwPollEvents();
+  // callbacks can close windows
+  std::vector<WebGPUWindow*> windows = WebGPUWindow::windows;
+  for (WebGPUWindow* window : windows) window->dispatchCoalescedEvents();
+}
+
+void WebGPUWindow::WaitEvents(double timeout) {
+  if (timeout > 0.0) glfwWaitEventsTimeout(timeout);
+  else glfwPollEvents();
+  std::vector<WebGPUWindow*> windows = WebGPUWindow::windows;
+  for (WebGPUWindow* window : windows) window->dispatchCoalescedEvents();
+}
+
+void WebGPUWindow::dispatchCoalescedEvents() {
+  if (this->pendingResize) this->dispatchResize();
+  if (this->pendingMouseMove) this->dispatchMouseMove();
+}
+
+void WebGPUWindow::pushEvent(WebGPUWindow* self, uint32_t type, uint32_t code, uint32_t mods, double x, double y, double deltaX, double deltaY) {
+  EventQueue::Record record;
+  record.type = type;
+  record.code = code;
+  record.mods = mods;
+  record.reserved = 0;
+  record.x = x;
+  record.y = y;
+  record.deltaX = deltaX;
+  record.deltaY = deltaY;
+  self->eventQueue->push(record);
 }
 
 void WebGPUWindow::onWindowResize(GLFWwindow* window, int width, int height) {
   WebGPUWindow* self = static_cast<WebGPUWindow*>(glfwGetWindowUserPointer(window));
-  Napi::Env env = self->env_;
-  if (width != self->width || height != self->height) {
+  if (width != self->width || height != self->height) self->pendingResize = true;
+  self->width = width;
+  self->height = height;
+  // the swapchain gets reconfigured with the last size of the poll
+  if (!self->coalesceEvents) self->dispatchResize();
+}
+
+void WebGPUWindow::dispatchResize() {
+  Napi::Env env = this->env_;
+  if (this->pendingResize && this->swapChain != nullptr) {
     // reconfigurate swapchain
-    GPUSwapChain* swapChain = self->swapChain;
+    GPUSwapChain* swapChain = this->swapChain;
     wgpuSwapChainConfigure(
       swapChain->instance,
       swapChain->format,
       swapChain->usage,
-      width,
-      height
+      this->width,
+      this->height
     );
   }
-  self->width = width;
-  self->height = height;
+  this->pendingResize = false;
 
-  if (self->onresize.IsEmpty()) return;
+  if (this->eventQueue != nullptr) {
+    WebGPUWindow::pushEvent(this, EventQueue::kResize, 0, 0, this->width, this->height, 0, 0);
+    return;
+  }
+  if (this->onresize.IsEmpty()) return;
   Napi::Object out = Napi::Object::New(env);
-  out.Set("width", Napi::Number::New(env, self->width));
-  out.Set("height", Napi::Number::New(env, self->height));
-  self->onresize.Value().As<Napi::Function>()({ out });
+  out.Set("width", Napi::Number::New(env, this->width));
+  out.Set("height", Napi::Number::New(env, this->height));
+  this->onresize.Value().As<Napi::Function>()({ out });
 }
 
 void WebGPUWindow::onWindowFocus(GLFWwindow* window, int focused) {
   WebGPUWindow* self = static_cast<WebGPUWindow*>(glfwGetWindowUserPointer(window));
   Napi::Env env = self->env_;
+  if (self->eventQueue != nullptr) {
+    WebGPUWindow::pushEvent(self, EventQueue::kFocus, !!focused, 0, 0, 0, 0, 0);
+    return;
+  }
   if (self->onfocus.IsEmpty()) return;
   Napi::Object out = Napi::Object::New(env);
   out.Set("focused", Napi::Boolean::New(env, !!focused));
@@ -101,7 +182,10 @@ void WebGPUWindow::onWindowFocus(GLFWwindow* window, int focused) {
 void WebGPUWindow::onWindowClose(GLFWwindow* window) {
   WebGPUWindow* self = static_cast<WebGPUWindow*>(glfwGetWindowUserPointer(window));
   Napi::Env env = self->env_;
-  if (!self->onclose.IsEmpty()) {
+  if (self->eventQueue != nullptr) {
+    WebGPUWindow::pushEvent(self, EventQueue::kClose, 0, 0, 0, 0, 0, 0);
+  }
+  else if (!self->onclose.IsEmpty()) {
     Napi::Object out = Napi::Object::New(env);
     self->onclose.Value().As<Napi::Function>()({ out });
   }
@@ -115,6 +199,11 @@ void WebGPUWindow::onWindowClose(GLFWwindow* window) {
 void WebGPUWindow::onWindowKeyPress(GLFWwindow* window, int key, int scancode, int action, int mods) {
   WebGPUWindow* self = static_cast<WebGPUWindow*>(glfwGetWindowUserPointer(window));
   Napi::Env env = self->env_;
+  if (self->eventQueue != nullptr) {
+    if (action == GLFW_PRESS) WebGPUWindow::pushEvent(self, EventQueue::kKeyDown, key, mods, 0, 0, 0, 0);
+    else if (action == GLFW_RELEASE) WebGPUWindow::pushEvent(self, EventQueue::kKeyUp, key, mods, 0, 0, 0, 0);
+    return;
+  }
   Napi::Object out = Napi::Object::New(env);
   out.Set("keyCode", Napi::Number::New(env, key));
   // press
@@ -133,27 +222,49 @@ void WebGPUWindow::onWindowKeyPress(GLFWwindow* window, int key, int scancode, i
 
 void WebGPUWindow::onWindowMouseMove(GLFWwindow* window, double x, double y) {
   WebGPUWindow* self = static_cast<WebGPUWindow*>(glfwGetWindowUserPointer(window));
-  Napi::Env env = self->env_;
-  Napi::Object out = Napi::Object::New(env);
-  double movementX = self->mouseLastX - x;
-  double movementY = self->mouseLastY - y;
+  self->pendingMovementX += self->mouseLastX - x;
+  self->pendingMovementY += self->mouseLastY - y;
   self->mouseLastX = x;
   self->mouseLastY = y;
-  if (self->onmousemove.IsEmpty()) return;
+  self->pendingMouseMove = true;
+  if (!self->coalesceEvents) self->dispatchMouseMove();
+}
+
+void WebGPUWindow::dispatchMouseMove() {
+  Napi::Env env = this->env_;
+  double x = this->mouseLastX;
+  double y = this->mouseLastY;
+  double movementX = this->pendingMovementX;
+  double movementY = this->pendingMovementY;
+  this->pendingMovementX = 0;
+  this->pendingMovementY = 0;
+  this->pendingMouseMove = false;
+  if (this->eventQueue != nullptr) {
+    WebGPUWindow::pushEvent(this, EventQueue::kMouseMove, 0, 0, x, y, movementX, movementY);
+    return;
+  }
+  if (this->onmousemove.IsEmpty()) return;
+  Napi::Object out = Napi::Object::New(env);
   out.Set("x", Napi::Number::New(env, x));
   out.Set("y", Napi::Number::New(env, y));
   out.Set("movementX", Napi::Number::New(env, movementX));
   out.Set("movementY", Napi::Number::New(env, movementY));
-  self->onmousemove.Value().As<Napi::Function>()({ out });
+  this->onmousemove.Value().As<Napi::Function>()({ out });
 }
 
 void WebGPUWindow::onWindowMouseWheel(GLFWwindow* window, double deltaX, double deltaY) {
   WebGPUWindow* self = static_cast<WebGPUWindow*>(glfwGetWindowUserPointer(window));
   Napi::Env env = self->env_;
-  if (self->onmousewheel.IsEmpty()) return;
+  // the pending move happened before this event
+  if (self->pendingMouseMove) self->dispatchMouseMove();
+  if (self->eventQueue == nullptr && self->onmousewheel.IsEmpty()) return;
   double mouseX = 0;
   double mouseY = 0;
   glfwGetCursorPos(window, &mouseX, &mouseY);
+  if (self->eventQueue != nullptr) {
+    WebGPUWindow::pushEvent(self, EventQueue::kMouseWheel, 0, 0, mouseX, mouseY, deltaX, deltaY);
+    return;
+  }
   Napi::Object out = Napi::Object::New(env);
   out.Set("x", Napi::Number::New(env, mouseX));
   out.Set("y", Napi::Number::New(env, mouseY));
@@ -165,10 +276,17 @@ void WebGPUWindow::onWindowMouseWheel(GLFWwindow* window, double deltaX, double
 void WebGPUWindow::onWindowMouseButton(GLFWwindow* window, int button, int action, int mods) {
   WebGPUWindow* self = static_cast<WebGPUWindow*>(glfwGetWindowUserPointer(window));
   Napi::Env env = self->env_;
-  Napi::Object out = Napi::Object::New(env);
+  // the pending move happened before this event
+  if (self->pendingMouseMove) self->dispatchMouseMove();
   double mouseX = 0;
   double mouseY = 0;
   glfwGetCursorPos(window, &mouseX, &mouseY);
+  if (self->eventQueue != nullptr) {
+    if (action == GLFW_PRESS) WebGPUWindow::pushEvent(self, EventQueue::kMouseDown, button, mods, mouseX, mouseY, 0, 0);
+    else if (action == GLFW_RELEASE) WebGPUWindow::pushEvent(self, EventQueue::kMouseUp, button, mods, mouseX, mouseY, 0, 0);
+    return;
+  }
+  Napi::Object out = Napi::Object::New(env);
   out.Set("x", Napi::Number::New(env, mouseX));
   out.Set("y", Napi::Number::New(env, mouseY));
   out.Set("button", Napi::Number::New(env, button));
@@ -189,6 +307,10 @@ void WebGPUWindow::onWindowMouseButton(GLFWwindow* window, int button, int actio
 void WebGPUWindow::onWindowDrop(GLFWwindow* window, int count, const char** paths) {
   WebGPUWindow* self = static_cast<WebGPUWindow*>(glfwGetWindowUserPointer(window));
   Napi::Env env = self->env_;
+  // paths don't fit into a record, they are still passed to the callback
+  if (self->eventQueue != nullptr) {
+    WebGPUWindow::pushEvent(self, EventQueue::kDrop, count, 0, 0, 0, 0, 0);
+  }
   if (self->ondrop.IsEmpty()) return;
   Napi::Object out = Napi::Object::New(env);
   // fill paths
@@ -235,7 +357,24 @@ Napi::Value WebGPUWindow::pollEvents(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
   GLFWwindow* window = this->instance;
   if (!this->isClosed && !glfwWindowShouldClose(window)) {
-    glfwPollEvents();
+    WebGPUWindow::PollEvents();
+  }
+  return env.Undefined();
+}
+
+Napi::Value WebGPUWindow::drainEvents(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->eventQueue == nullptr) return Napi::Number::New(env, 0);
+  return Napi::Number::New(env, this->eventQueue->drain());
+}
+
+// blocks the JS thread until an event arrived, or the timeout (in ms) elapsed
+Napi::Value WebGPUWindow::waitEvents(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  GLFWwindow* window = this->instance;
+  double timeout = info[0].IsNumber() ? info[0].As<Napi::Number>().DoubleValue() : 0.0;
+  if (!this->isClosed && !glfwWindowShouldClose(window)) {
+    WebGPUWindow::WaitEvents(timeout * 1e-3);
   }
   return env.Undefined();
 }
@@ -270,7 +409,8 @@ void WebGPUWindow::Setwidth(const Napi::CallbackInfo& info, const Napi::Value& v
   this->width = value.As<Napi::Number>().Int32Value();
   if (!this->isClosed) {
     glfwSetWindowSize(window, this->width, this->height);
-    WebGPUWindow::onWindowResize(window, this->width, this->height);
+    this->pendingResize = true;
+    this->dispatchResize();
   }
 }
 
@@ -288,7 +428,8 @@ void WebGPUWindow::Setheight(const Napi::CallbackInfo& info, const Napi::Value&
   this->height = value.As<Napi::Number>().Int32Value();
   if (!this->isClosed) {
     glfwSetWindowSize(window, this->width, this->height);
-    WebGPUWindow::onWindowResize(window, this->width, this->height);
+    this->pendingResize = true;
+    this->dispatchResize();
   }
 }
 
@@ -319,6 +460,13 @@ Napi::Value WebGPUWindow::GetdevicePixelRatio(const Napi::CallbackInfo& info) {
   return Napi::Number::New(env, static_cast<int32_t>(width / this->width));
 }
 
+// eventBuffer
+Napi::Value WebGPUWindow::GeteventBuffer(const Napi::CallbackInfo& info) {
+  Napi::Env env = info.Env();
+  if (this->eventQueue == nullptr) return env.Null();
+  return this->eventQueue->buffer.Value();
+}
+
 // onresize
 Napi::Value WebGPUWindow::Getonresize(const Napi::CallbackInfo& info) {
   Napi::Env env = info.Env();
@@ -453,27 +601,44 @@ Napi::Object WebGPUWindow::Initialize(Napi::Env env, Napi::Object exports) {
   Napi::HandleScope scope(env);
   Napi::Function func = DefineClass(env, "WebGPUWindow", {
     // methods
-    InstanceMethod(
+    ProfiledMethod(
+      env, "WebGPUWindow",
       "getContext",
       &WebGPUWindow::getContext,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "WebGPUWindow",
       "pollEvents",
       &WebGPUWindow::pollEvents,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "WebGPUWindow",
+      "waitEvents",
+      &WebGPUWindow::waitEvents,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "WebGPUWindow",
+      "drainEvents",
+      &WebGPUWindow::drainEvents,
+      napi_enumerable
+    ),
+    ProfiledMethod(
+      env, "WebGPUWindow",
       "focus",
       &WebGPUWindow::focus,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "WebGPUWindow",
       "close",
       &WebGPUWindow::close,
       napi_enumerable
     ),
-    InstanceMethod(
+    ProfiledMethod(
+      env, "WebGPUWindow",
       "shouldClose",
       &WebGPUWindow::shouldClose,
       napi_enumerable
@@ -515,6 +680,12 @@ Napi::Object WebGPUWindow::Initialize(Napi::Env env, Napi::Object exports) {
       nullptr,
       napi_enumerable
     ),
+    InstanceAccessor(
+      "eventBuffer",
+      &WebGPUWindow::GeteventBuffer,
+      nullptr,
+      napi_enumerable
+    ),
     InstanceAccessor(
       "onresize",
       &WebGPUWindow::Getonresize,
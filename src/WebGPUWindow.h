@@ -3,6 +3,12 @@
 
 #include "Base.h"
 #include "GPUSwapChain.h"
+#include "EventQueue.h"
+#include "BackendBinding.h"
+
+#include <vector>
+
+class GPUDevice;
 
 class WebGPUWindow : public Napi::ObjectWrap<WebGPUWindow> {
 
@@ -23,6 +29,17 @@ class WebGPUWindow : public Napi::ObjectWrap<WebGPUWindow> {
 
     bool isClosed = false;
 
+    // when set, events are written into the queue instead of calling the callbacks
+    EventQueue* eventQueue = nullptr;
+
+    // mouse moves and resizes are only delivered once per poll, with the last
+    // position and size, the movement of all coalesced moves is accumulated
+    bool coalesceEvents = true;
+    bool pendingMouseMove = false;
+    double pendingMovementX = 0;
+    double pendingMovementY = 0;
+    bool pendingResize = false;
+
     // event callbacks
     Napi::FunctionReference onresize;
     Napi::FunctionReference onfocus;
@@ -39,11 +56,20 @@ class WebGPUWindow : public Napi::ObjectWrap<WebGPUWindow> {
 
     GLFWwindow* instance;
 
-    GPUSwapChain* swapChain;
+    GPUSwapChain* swapChain = nullptr;
+
+    // each window has its own binding, created for the device which presents to it
+    BackendBinding* binding = nullptr;
+    WGPUDevice bindingDevice = nullptr;
+
+    BackendBinding* getBinding(GPUDevice* device);
+    void releaseBinding(WGPUDevice device);
     WGPUTextureFormat preferredSwapChainFormat = WGPUTextureFormat_Undefined;
 
     Napi::Value getContext(const Napi::CallbackInfo &info);
     Napi::Value pollEvents(const Napi::CallbackInfo &info);
+    Napi::Value waitEvents(const Napi::CallbackInfo &info);
+    Napi::Value drainEvents(const Napi::CallbackInfo &info);
 
     Napi::Value focus(const Napi::CallbackInfo &info);
     Napi::Value close(const Napi::CallbackInfo &info);
@@ -63,6 +89,8 @@ class WebGPUWindow : public Napi::ObjectWrap<WebGPUWindow> {
 
     Napi::Value GetdevicePixelRatio(const Napi::CallbackInfo &info);
 
+    Napi::Value GeteventBuffer(const Napi::CallbackInfo &info);
+
     Napi::Value Getonresize(const Napi::CallbackInfo &info);
     void Setonresize(const Napi::CallbackInfo &info, const Napi::Value& value);
 
@@ -93,6 +121,20 @@ class WebGPUWindow : public Napi::ObjectWrap<WebGPUWindow> {
     Napi::Value Getondrop(const Napi::CallbackInfo &info);
     void Setondrop(const Napi::CallbackInfo &info, const Napi::Value& value);
 
+    // all open windows, their coalesced events get dispatched after each poll
+    static std::vector<WebGPUWindow*> windows;
+
+    // polls the events of all windows
+    static void PollEvents();
+    // like 'PollEvents', but sleeps until an event arrived or the timeout (in seconds) elapsed
+    static void WaitEvents(double timeout);
+
+    void dispatchMouseMove();
+    void dispatchResize();
+    void dispatchCoalescedEvents();
+
+    static void pushEvent(WebGPUWindow* self, uint32_t type, uint32_t code, uint32_t mods, double x, double y, double deltaX, double deltaY);
+
     static void onWindowResize(GLFWwindow*, int, int);
     static void onWindowFocus(GLFWwindow*, int);
     static void onWindowClose(GLFWwindow*);
@@ -0,0 +1,531 @@
+import fs from "fs";
+import WebGPU from "../index.js";
+
+Object.assign(global, WebGPU);
+
+// usage: npm run benchmark -- [samples] [output.json]
+const SAMPLES = parseInt(process.argv[2]) || 500;
+const OUTPUT_PATH = process.argv[3] || null;
+
+// cheap calls are timed in batches, since a single
+// call is below the resolution of the timer
+const BATCH_SIZE = 32;
+const WARMUP_SAMPLES = 16;
+
+const vsSrc = `
+  #version 450
+  #pragma shader_stage(vertex)
+  const vec2 pos[3] = vec2[3](
+    vec2(0.0f, 0.5f),
+    vec2(-0.5f, -0.5f),
+    vec2(0.5f, -0.5f)
+  );
+  void main() {
+    gl_Position = vec4(pos[gl_VertexIndex], 0.0, 1.0);
+  }
+`;
+
+const fsSrc = `
+  #version 450
+  #pragma shader_stage(fragment)
+  layout(location = 0) out vec4 outColor;
+  void main() {
+    outColor = vec4(1.0, 0.0, 0.0, 1.0);
+  }
+`;
+
+const csSrc = `
+  #version 450
+  #pragma shader_stage(compute)
+  layout(local_size_x = 1) in;
+  void main() { }
+`;
+
+function percentile(sorted, p) {
+  let index = Math.min(sorted.length - 1, Math.floor(sorted.length * p));
+  return sorted[index];
+};
+
+function summarize(name, batchSize, times) {
+  let sorted = Float64Array.from(times).sort();
+  let sum = 0;
+  for (let ii = 0; ii < sorted.length; ++ii) sum += sorted[ii];
+  // all values are nanoseconds per call
+  return {
+    name,
+    samples: sorted.length,
+    batchSize,
+    mean: sum / sorted.length,
+    min: sorted[0],
+    p50: percentile(sorted, 0.50),
+    p90: percentile(sorted, 0.90),
+    p99: percentile(sorted, 0.99),
+    max: sorted[sorted.length - 1]
+  };
+};
+
+let results = [];
+
+function bench(name, fn, batchSize = BATCH_SIZE, samples = SAMPLES) {
+  for (let ii = 0; ii < WARMUP_SAMPLES; ++ii) fn();
+  let times = new Float64Array(samples);
+  for (let ii = 0; ii < samples; ++ii) {
+    let start = process.hrtime.bigint();
+    for (let jj = 0; jj < batchSize; ++jj) fn();
+    times[ii] = Number(process.hrtime.bigint() - start) / batchSize;
+  };
+  results.push(summarize(name, batchSize, times));
+};
+
+async function benchAsync(name, fn, samples = SAMPLES) {
+  for (let ii = 0; ii < WARMUP_SAMPLES; ++ii) await fn();
+  let times = new Float64Array(samples);
+  for (let ii = 0; ii < samples; ++ii) {
+    let start = process.hrtime.bigint();
+    await fn();
+    times[ii] = Number(process.hrtime.bigint() - start);
+  };
+  results.push(summarize(name, 1, times));
+};
+
+(async function main() {
+
+  const adapter = await GPU.requestAdapter({ preferredBackend: "Null" });
+
+  const device = await adapter.requestDevice();
+
+  const queue = device.getQueue();
+
+  const format = "rgba8unorm";
+
+  const vertexShaderModule = device.createShaderModule({ code: vsSrc });
+  const fragmentShaderModule = device.createShaderModule({ code: fsSrc });
+
+  const uniformBuffer = device.createBuffer({
+    size: 256,
+    usage: GPUBufferUsage.UNIFORM | GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST
+  });
+
+  const vertexBuffer = device.createBuffer({
+    size: 4096,
+    usage: GPUBufferUsage.VERTEX | GPUBufferUsage.COPY_DST
+  });
+
+  const indexBuffer = device.createBuffer({
+    size: 4096,
+    usage: GPUBufferUsage.INDEX | GPUBufferUsage.COPY_DST
+  });
+
+  // draw, draw indexed and dispatch arguments
+  const indirectBuffer = device.createBuffer({
+    size: 256,
+    usage: GPUBufferUsage.INDIRECT | GPUBufferUsage.COPY_DST
+  });
+
+  const mappableBuffer = device.createBuffer({
+    size: 4096,
+    usage: GPUBufferUsage.MAP_WRITE | GPUBufferUsage.COPY_SRC
+  });
+
+  // rows of the 64x64 texture, 256 bytes each
+  const copyBuffer = device.createBuffer({
+    size: 64 * 64 * 4,
+    usage: GPUBufferUsage.COPY_SRC | GPUBufferUsage.COPY_DST
+  });
+
+  const bindGroupLayoutDescriptor = {
+    entries: [{
+      binding: 0,
+      visibility: GPUShaderStage.FRAGMENT,
+      type: "uniform-buffer"
+    }]
+  };
+
+  const bindGroupLayout = device.createBindGroupLayout(bindGroupLayoutDescriptor);
+
+  const bindGroupDescriptor = {
+    layout: bindGroupLayout,
+    entries: [{
+      binding: 0,
+      buffer: uniformBuffer,
+      offset: 0,
+      size: 256
+    }]
+  };
+
+  const bindGroup = device.createBindGroup(bindGroupDescriptor);
+
+  const layout = device.createPipelineLayout({
+    bindGroupLayouts: [bindGroupLayout]
+  });
+
+  const pipelineDescriptor = {
+    layout,
+    sampleCount: 1,
+    vertexStage: {
+      module: vertexShaderModule,
+      entryPoint: "main"
+    },
+    fragmentStage: {
+      module: fragmentShaderModule,
+      entryPoint: "main"
+    },
+    primitiveTopology: "triangle-list",
+    vertexInput: {
+      indexFormat: "uint32",
+      buffers: []
+    },
+    rasterizationState: {
+      frontFace: "CCW",
+      cullMode: "none"
+    },
+    colorStates: [{
+      format,
+      alphaBlend: {},
+      colorBlend: {}
+    }]
+  };
+
+  const pipeline = device.createRenderPipeline(pipelineDescriptor);
+
+  // a second pipeline to alternate with, dawn returns the same
+  // pipeline for identical descriptors
+  const cullingPipeline = device.createRenderPipeline(Object.assign({}, pipelineDescriptor, {
+    rasterizationState: {
+      frontFace: "CCW",
+      cullMode: "back"
+    }
+  }));
+
+  const computePipeline = device.createComputePipeline({
+    layout: device.createPipelineLayout({ bindGroupLayouts: [] }),
+    computeStage: {
+      module: device.createShaderModule({ code: csSrc }),
+      entryPoint: "main"
+    }
+  });
+
+  const textureDescriptor = {
+    size: { width: 64, height: 64, depth: 1 },
+    arrayLayerCount: 1,
+    mipLevelCount: 1,
+    sampleCount: 1,
+    dimension: "2d",
+    format,
+    usage: GPUTextureUsage.OUTPUT_ATTACHMENT | GPUTextureUsage.COPY_SRC | GPUTextureUsage.COPY_DST
+  };
+
+  const texture = device.createTexture(textureDescriptor);
+  const textureView = texture.createView({ format });
+
+  const renderPassDescriptor = {
+    colorAttachments: [{
+      clearColor: { r: 0.0, g: 0.0, b: 0.0, a: 1.0 },
+      loadOp: "clear",
+      storeOp: "store",
+      attachment: textureView
+    }]
+  };
+
+  const uploadData = new Uint8Array(256);
+  const textureData = new Uint8Array(64 * 64 * 4);
+
+  // object creation and descriptor decoding
+  bench("device.createBuffer", () => {
+    device.createBuffer({ size: 256, usage: GPUBufferUsage.UNIFORM });
+  });
+  bench("device.createTexture", () => {
+    device.createTexture(textureDescriptor);
+  });
+  bench("texture.createView", () => {
+    texture.createView({ format });
+  });
+  bench("device.createSampler", () => {
+    device.createSampler({ magFilter: "linear", minFilter: "linear" });
+  });
+  bench("device.createBindGroupLayout", () => {
+    device.createBindGroupLayout(bindGroupLayoutDescriptor);
+  });
+  bench("device.createBindGroup", () => {
+    device.createBindGroup(bindGroupDescriptor);
+  });
+  bench("device.createPipelineLayout", () => {
+    device.createPipelineLayout({ bindGroupLayouts: [bindGroupLayout] });
+  });
+  bench("device.createShaderModule", () => {
+    device.createShaderModule({ code: fsSrc });
+  }, 1, Math.min(SAMPLES, 100));
+  bench("device.createRenderPipeline", () => {
+    device.createRenderPipeline(pipelineDescriptor);
+  }, 1);
+  bench("device.createCommandEncoder", () => {
+    device.createCommandEncoder({});
+  });
+
+  // data uploads
+  bench("buffer.setSubData", () => {
+    uniformBuffer.setSubData(0, uploadData);
+  });
+  bench("queue.writeTexture", () => {
+    queue.writeTexture(
+      { texture },
+      textureData,
+      { bytesPerRow: 64 * 4 },
+      { width: 64, height: 64, depth: 1 }
+    );
+  });
+  bench("device.allocateUniforms", () => {
+    device.allocateUniforms(256).data[0] = 1.0;
+    device.endUniformFrame();
+  });
+  queue.submit([]);
+
+  // encoder calls, the set calls alternate their state, so they always
+  // reach dawn, the '.elided' entries measure the early-out of redundant sets
+  {
+    const pipelines = [ pipeline, cullingPipeline ];
+    const bindGroups = [
+      bindGroup,
+      device.createBindGroup(bindGroupDescriptor)
+    ];
+    const commandEncoder = device.createCommandEncoder({});
+    const renderPass = commandEncoder.beginRenderPass(renderPassDescriptor);
+    let index = 0;
+    bench("renderPass.setPipeline", () => {
+      renderPass.setPipeline(pipelines[(index++) & 1]);
+    });
+    bench("renderPass.setPipeline.elided", () => {
+      renderPass.setPipeline(pipeline);
+    });
+    bench("renderPass.setBindGroup", () => {
+      renderPass.setBindGroup(0, bindGroups[(index++) & 1]);
+    });
+    bench("renderPass.setBindGroup.elided", () => {
+      renderPass.setBindGroup(0, bindGroup);
+    });
+    bench("renderPass.setVertexBuffer", () => {
+      renderPass.setVertexBuffer(0, vertexBuffer, ((index++) & 1) * 256);
+    });
+    bench("renderPass.setVertexBuffer.elided", () => {
+      renderPass.setVertexBuffer(0, vertexBuffer, 0);
+    });
+    bench("renderPass.setIndexBuffer", () => {
+      renderPass.setIndexBuffer(indexBuffer, ((index++) & 1) * 256);
+    });
+    bench("renderPass.setIndexBuffer.elided", () => {
+      renderPass.setIndexBuffer(indexBuffer, 0);
+    });
+    bench("renderPass.setViewport", () => {
+      renderPass.setViewport(0, 0, 64, 64, 0, 1);
+    });
+    bench("renderPass.setScissorRect", () => {
+      renderPass.setScissorRect(0, 0, 64, 64);
+    });
+    bench("renderPass.draw", () => {
+      renderPass.draw(3, 1, 0, 0);
+    });
+    bench("renderPass.drawIndexed", () => {
+      renderPass.drawIndexed(3, 1, 0, 0, 0);
+    });
+    bench("renderPass.drawIndirect", () => {
+      renderPass.drawIndirect(indirectBuffer, 0);
+    });
+    bench("renderPass.drawIndexedIndirect", () => {
+      renderPass.drawIndexedIndirect(indirectBuffer, 0);
+    });
+    bench("renderPass.pushDebugGroup+popDebugGroup", () => {
+      renderPass.pushDebugGroup("group");
+      renderPass.popDebugGroup();
+    });
+    renderPass.endPass();
+    queue.submit([ commandEncoder.finish() ]);
+  }
+
+  {
+    const commandEncoder = device.createCommandEncoder({});
+    const computePass = commandEncoder.beginComputePass({});
+    computePass.setPipeline(computePipeline);
+    bench("computePass.dispatch", () => {
+      computePass.dispatch(1, 1, 1);
+    });
+    bench("computePass.dispatchIndirect", () => {
+      computePass.dispatchIndirect(indirectBuffer, 0);
+    });
+    computePass.endPass();
+    queue.submit([ commandEncoder.finish() ]);
+  }
+
+  // render bundles, encoding a bundle of 16 draws and executing it
+  {
+    const bundleEncoderDescriptor = { colorFormats: [ format ] };
+    const encodeBundle = () => {
+      const bundleEncoder = device.createRenderBundleEncoder(bundleEncoderDescriptor);
+      bundleEncoder.setPipeline(pipeline);
+      bundleEncoder.setBindGroup(0, bindGroup);
+      for (let ii = 0; ii < 16; ++ii) bundleEncoder.draw(3, 1, 0, 0);
+      return bundleEncoder.finish({});
+    };
+    bench("renderBundleEncoder.encode+finish", encodeBundle, 1);
+    const bundles = [ encodeBundle() ];
+    const commandEncoder = device.createCommandEncoder({});
+    const renderPass = commandEncoder.beginRenderPass(renderPassDescriptor);
+    bench("renderPass.executeBundles", () => {
+      renderPass.executeBundles(bundles);
+    });
+    renderPass.endPass();
+    queue.submit([ commandEncoder.finish() ]);
+  }
+
+  // fences
+  {
+    const fence = queue.createFence({ initialValue: 0 });
+    let value = 0;
+    bench("queue.createFence", () => {
+      queue.createFence({ initialValue: 0 });
+    });
+    bench("queue.signal", () => {
+      queue.signal(fence, ++value);
+    });
+    bench("fence.getCompletedValue", () => {
+      fence.getCompletedValue();
+    });
+  }
+
+  // calls which always reach dawn, alternating state defeats the
+  // redundant state elision, so the proc dispatch itself gets measured
+  // compare a build with and without '--dawn_native_procs'
+  {
+    const bindGroups = [
+      bindGroup,
+      device.createBindGroup(bindGroupDescriptor)
+    ];
+    const commandEncoder = device.createCommandEncoder({});
+    const renderPass = commandEncoder.beginRenderPass(renderPassDescriptor);
+    renderPass.setPipeline(pipeline);
+    let index = 0;
+    bench("dispatch.renderPass.setBindGroup", () => {
+      renderPass.setBindGroup(0, bindGroups[(index++) & 1]);
+    });
+    bench("dispatch.renderPass.draw", () => {
+      renderPass.draw(3);
+    });
+    bench("dispatch.renderPass.setBindGroup+draw", () => {
+      renderPass.setBindGroup(0, bindGroups[(index++) & 1]);
+      renderPass.draw(3);
+    });
+    renderPass.endPass();
+    queue.submit([ commandEncoder.finish() ]);
+  }
+
+  // calls with little native work, so the js side of the interface dominates
+  // compare a build with and without '--disable_minification'
+  {
+    const commandEncoder = device.createCommandEncoder({});
+    bench("js.device.createCommandEncoder", () => {
+      device.createCommandEncoder();
+    });
+    bench("js.texture.createView", () => {
+      texture.createView({ format });
+    });
+    bench("js.commandEncoder.beginComputePass+endPass", () => {
+      commandEncoder.beginComputePass({}).endPass();
+    });
+    queue.submit([ commandEncoder.finish() ]);
+  }
+
+  bench("commandEncoder.beginRenderPass+endPass", () => {
+    const commandEncoder = device.createCommandEncoder({});
+    const renderPass = commandEncoder.beginRenderPass(renderPassDescriptor);
+    renderPass.endPass();
+  });
+
+  bench("commandEncoder.copyBufferToBuffer", () => {
+    const commandEncoder = device.createCommandEncoder({});
+    commandEncoder.copyBufferToBuffer(mappableBuffer, 0, uniformBuffer, 0, 256);
+  });
+
+  bench("commandEncoder.copyBufferToTexture", () => {
+    const commandEncoder = device.createCommandEncoder({});
+    commandEncoder.copyBufferToTexture(
+      { buffer: copyBuffer, offset: 0, bytesPerRow: 64 * 4 },
+      { texture, origin: { x: 0, y: 0, z: 0 } },
+      { width: 64, height: 64, depth: 1 }
+    );
+  });
+
+  bench("commandEncoder.copyTextureToBuffer", () => {
+    const commandEncoder = device.createCommandEncoder({});
+    commandEncoder.copyTextureToBuffer(
+      { texture, origin: { x: 0, y: 0, z: 0 } },
+      { buffer: copyBuffer, offset: 0, bytesPerRow: 64 * 4 },
+      { width: 64, height: 64, depth: 1 }
+    );
+  });
+
+  bench("commandEncoder.finish", () => {
+    device.createCommandEncoder({}).finish();
+  });
+
+  bench("queue.submit", () => {
+    const commandEncoder = device.createCommandEncoder({});
+    const renderPass = commandEncoder.beginRenderPass(renderPassDescriptor);
+    renderPass.setPipeline(pipeline);
+    renderPass.setBindGroup(0, bindGroup);
+    renderPass.draw(3, 1, 0, 0);
+    renderPass.endPass();
+    queue.submit([ commandEncoder.finish() ]);
+  }, 1);
+
+  // mapping
+  await benchAsync("buffer.mapWriteAsync+unmap", async() => {
+    await mappableBuffer.mapWriteAsync();
+    mappableBuffer.unmap();
+  });
+
+  await benchAsync("queue.readBuffer", async() => {
+    await queue.readBuffer(uniformBuffer, 0, 256);
+  });
+
+  // capture a few frames, including their resources, and replay them
+  {
+    GPU.startCapture();
+    const buffer = device.createBuffer({
+      size: 256,
+      usage: GPUBufferUsage.UNIFORM | GPUBufferUsage.COPY_DST
+    });
+    const group = device.createBindGroup({
+      layout: bindGroupLayout,
+      entries: [{ binding: 0, buffer, offset: 0, size: 256 }]
+    });
+    for (let ii = 0; ii < 8; ++ii) {
+      buffer.setSubData(0, uploadData);
+      const commandEncoder = device.createCommandEncoder({});
+      const renderPass = commandEncoder.beginRenderPass(renderPassDescriptor);
+      renderPass.setPipeline(pipeline);
+      renderPass.setBindGroup(0, group);
+      for (let jj = 0; jj < 64; ++jj) renderPass.draw(3, 1, 0, 0);
+      renderPass.endPass();
+      queue.submit([ commandEncoder.finish() ]);
+    };
+    const capture = GPU.stopCapture();
+    bench("GPU.replayCapture", () => {
+      GPU.replayCapture(device, capture);
+    }, 1, Math.min(SAMPLES, 100));
+  }
+
+  const report = {
+    backend: "Null",
+    dawnProcs: GPU.dawnProcs,
+    packedDescriptors: GPU.packedDescriptors,
+    minifiedInterface: GPU.minifiedInterface,
+    platform: process.platform,
+    node: process.version,
+    unit: "ns",
+    results
+  };
+
+  const json = JSON.stringify(report, null, 2);
+  if (OUTPUT_PATH) fs.writeFileSync(OUTPUT_PATH, json);
+  else process.stdout.write(json + "\n");
+
+})();
@@ -82,7 +82,7 @@ const fsSrc = `
   });
 
   function onFrame() {
-    if (!window.shouldClose()) setTimeout(onFrame, 1e3 / 60);
+    if (!window.shouldClose()) swapChain.requestFrame(onFrame);
 
     const backBuffer = swapChain.getCurrentTexture();
     const backBufferView = backBuffer.createView({
@@ -106,6 +106,6 @@ const fsSrc = `
     swapChain.present(backBuffer);
     window.pollEvents();
   };
-  setTimeout(onFrame, 1e3 / 60);
+  swapChain.requestFrame(onFrame);
 
 })();